@@ -0,0 +1,44 @@
+#include "AllocationCounter.h"
+
+#include <bits/stdc++.h>
+
+#ifdef COUNT_ALLOCATIONS
+
+/* per thread, so that a search is not blamed for the allocations of the threads running next to it */
+static thread_local size_t allocationCount = 0;
+
+size_t getAllocationCount() {
+    return allocationCount;
+}
+
+void* operator new(size_t size) {
+    allocationCount++;
+
+    void *ptr = malloc(size ? size : 1);
+    if (!ptr)
+        throw std::bad_alloc();
+
+    return ptr;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+    free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept {
+    free(ptr);
+}
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <bits/stdc++.h>
+
+/*
+  Counts heap allocations when built with COUNT_ALLOCATIONS defined (make COUNT_ALLOCATIONS=1),
+  by replacing the global operator new. Used to check that the search does not allocate.
+ */
+#ifdef COUNT_ALLOCATIONS
+
+/**
+ * Get the number of calls to operator new made by the calling thread since it started.
+ */
+size_t getAllocationCount();
+
+#endif
+
+#endif
@@ -0,0 +1,80 @@
+#include "Bench.h"
+
+#include <bits/stdc++.h>
+
+#include "Position.h"
+#include "SearchContext.h"
+#include "TimeManager.h"
+#include "TranspositionTable.h"
+
+/* middlegame positions with pieces in hand */
+static const char *benchPositions[] = {
+    "r1bqkb1r/p4pp1/2p2n1p/n7/4p3/5N2/PPPPBPPP/RNBQK2R[PPp] w KQkq - 0 10",
+    "r2qkbnr/pp1npppp/2p3b1/8/3P4/5NN1/PPP2PPP/R1BQKB1R[Pp] w KQkq - 5 7",
+    "r2qk2r/p1p1nppp/Bpn1p3/3pP3/3P4/2P2N2/P1P2PPP/R1BQ1RK1[BBn] b kq - 0 9",
+    "r3kbnr/ppp2ppp/2n5/4P3/2B3b1/4PP2/PP4PP/RNBK2NR[QPPqp] b kq - 0 7",
+    "r1bq1rk1/ppp2pp1/2np3p/2bNp3/2B1P3/2PP1N2/PP3PPP/R2QK2R[Nb] w KQ - 1 10",
+    "r2q1rk1/pppn1ppp/3b1n2/3p2B1/3P2b1/3B1N2/PPPN1PPP/R2Q1RK1[Pp] w - - 10 9",
+    "rn2kb1r/pp3ppp/2p1pn2/q7/2BPp3/2N2Q1P/PPPB1PP1/R3K2R[BPn] w KQkq - 0 10",
+    "r1bq1rk1/p1p1bppp/2pp3n/6N1/3PP3/5N1P/PPP2PP1/RNBQK2R[bp] b KQ - 1 10",
+    "r1bq1b1r/ppp3pp/2n1k3/3np3/2B5/2N2Q2/PPPP1PPP/R1B1K2R[PPnp] b KQ - 3 8",
+};
+
+uint64_t runBench(int depth, int threads, std::ostream &out) {
+    TranspositionTable *transpositionTable = new TranspositionTable();
+    std::atomic<bool> stopSignal(false);
+
+    TimeManager timeManager;
+    timeManager.setDepthLimit(depth);
+
+    int count = sizeof(benchPositions) / sizeof(benchPositions[0]);
+    uint64_t nodes = 0, signature = 0xCBF29CE484222325ULL;
+    int64_t ms = 0;
+
+    for (int i = 0; i < count; i++) {
+        Position position;
+        position.setFEN(benchPositions[i]);
+
+        /* every position starts from an empty table and fresh ordering tables, so that its node count
+           does not depend on the positions searched before it */
+        transpositionTable->clear();
+        std::vector<SearchContext*> searchContexts;
+        for (int id = 0; id < threads; id++)
+            searchContexts.push_back(new SearchContext(transpositionTable, &stopSignal, id, &searchContexts));
+
+        /* Lazy SMP as in Bot::search: the helpers run until the main thread has its move */
+        std::vector<std::thread> helpers;
+        stopSignal = false;
+        timeManager.startUnlimited();
+
+        for (int id = 1; id < threads; id++)
+            helpers.emplace_back([&searchContexts, id, &position, &timeManager] {
+                searchContexts[id]->search(position, timeManager);
+            });
+
+        PackedMove bestMove = searchContexts[0]->search(position, timeManager);
+
+        stopSignal = true;
+        for (std::thread &helper : helpers)
+            helper.join();
+        ms += timeManager.elapsed();
+
+        /* FNV-1a over the node counts, so that changes in different positions do not cancel out */
+        uint64_t positionNodes = searchContexts[0]->getTotalNodes();
+        nodes += positionNodes;
+        signature = (signature ^ positionNodes) * 0x100000001B3ULL;
+
+        out << "Position " << i + 1 << "/" << count << ": " << bestMove.toString()
+            << " nodes " << positionNodes << "\n";
+
+        for (SearchContext *searchContext : searchContexts)
+            delete searchContext;
+    }
+
+    out << "Nodes: " << nodes << " Time: " << ms << " ms NPS: " << nodes * 1000 / std::max<int64_t>(ms, 1)
+        << " Signature: " << signature << " Threads: " << threads << "\n";
+
+    delete transpositionTable;
+
+    return signature;
+}
@@ -0,0 +1,18 @@
+#ifndef BENCH_H
+#define BENCH_H
+#include <bits/stdc++.h>
+
+#define BENCH_DEPTH 6  /* default depth of the bench searches */
+
+/**
+ * Search a fixed set of crazyhouse middlegame positions to a fixed depth, with an empty transposition
+ * table, and print the nodes of all the threads, the time, the nodes per second and a signature of the
+ * node counts. With a single thread, the signature only changes when the search itself changes; with
+ * more, it varies from run to run, and the nodes per second measure how the search scales.
+ * @param depth depth of every search
+ * @param threads number of search threads
+ * @param out stream the results are printed to
+ * @return the signature
+ */
+uint64_t runBench(int depth, int threads, std::ostream &out);
+#endif
@@ -0,0 +1,198 @@
+#include "Bitboard.h"
+
+#include <bits/stdc++.h>
+
+Magic rookMagics[SQUARES];
+Magic bishopMagics[SQUARES];
+
+/* attacks of all the squares, for every subset of their relevant occupancy */
+static Bitboard rookTable[0x19000];
+static Bitboard bishopTable[0x1480];
+
+Bitboard knightAttacks[SQUARES];
+Bitboard kingAttacks[SQUARES];
+Bitboard pawnAttacks[2][SQUARES];
+Bitboard betweenBB[SQUARES][SQUARES];
+Bitboard lineBB[SQUARES][SQUARES];
+
+/* rank and file increments, also used by the queen, king */
+static const int dx[] = {-1, -1, -1,  0,  1,  1,  1,  0};
+static const int dy[] = {-1,  0,  1,  1,  1,  0, -1, -1};
+
+static const int knight_dx[] = {-2, -2, -1,  1,  2,  2,  1, -1};
+static const int knight_dy[] = {-1,  1,  2,  2,  1, -1, -2, -2};
+
+static const int rook_dx[] = {-1, 0, 1,  0};
+static const int rook_dy[] = { 0, 1, 0, -1};
+
+static const int bishop_dx[] = {-1,  1,  1, -1};
+static const int bishop_dy[] = {-1, -1,  1, 1};
+
+static bool isOnBoard(int rank, int file) {
+    return rank >= 1 && rank <= 8 && file >= 1 && file <= 8;
+}
+
+/**
+ * Compute the squares reachable in one step from sq.
+ * @param directions number of directions
+ * @param dx, dy rank and file increments for each direction
+*/
+static Bitboard stepAttacks(int sq, int directions, const int dx[], const int dy[]) {
+    Bitboard attacks = 0;
+
+    for (int i = 0; i < directions; i++) {
+        int rank = rankOf(sq) + dx[i], file = fileOf(sq) + dy[i];
+        if (isOnBoard(rank, file))
+            attacks |= squareBB(makeSquare(rank, file));
+    }
+
+    return attacks;
+}
+
+/**
+ * Walk each ray from sq until the edge of the board or the first occupied square (included).
+ * @param occupied occupied squares
+ * @param directions number of directions
+ * @param dx, dy rank and file increments for each direction
+*/
+static Bitboard slidingAttacks(int sq, Bitboard occupied, int directions, const int dx[], const int dy[]) {
+    Bitboard attacks = 0;
+
+    for (int i = 0; i < directions; i++) {
+        int rank = rankOf(sq) + dx[i], file = fileOf(sq) + dy[i];
+
+        while (isOnBoard(rank, file)) {
+            Bitboard b = squareBB(makeSquare(rank, file));
+            attacks |= b;
+            if (occupied & b)
+                break;
+
+            rank += dx[i];
+            file += dy[i];
+        }
+    }
+
+    return attacks;
+}
+
+#ifndef USE_PEXT
+/**
+ * xorshift64* pseudo-random number generator.
+ * @param state generator state, seeded per rank so that the magics are found quickly
+ *              and are the same on every run
+*/
+static uint64_t randomNumber(uint64_t &state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 2685821657736338717ULL;
+}
+#endif
+
+/**
+ * Fill the magics and the attack table of a sliding piece.
+ * @param table attack table shared by all squares
+ * @param magics magic of each square
+ * @param dx, dy rank and file increments for each of the 4 directions of the piece
+*/
+static void initMagics(Bitboard table[], Magic magics[], const int dx[], const int dy[]) {
+#ifndef USE_PEXT
+    static const uint64_t seeds[] = {728, 10316, 55013, 32803, 12281, 15100, 16645, 255};
+    static Bitboard occupancy[4096], reference[4096];
+    static int epoch[4096];
+    int attempt = 0;
+#endif
+    Bitboard *next = table;
+
+    for (int sq = 0; sq < SQUARES; sq++) {
+        Magic &m = magics[sq];
+
+        /* board edges are not relevant, unless the piece is on them */
+        Bitboard edges = ((RANK_1 | RANK_8) & ~(RANK_1 << (8 * (rankOf(sq) - 1))))
+                       | ((FILE_A | FILE_H) & ~(FILE_A << (fileOf(sq) - 1)));
+
+        m.mask = slidingAttacks(sq, 0, 4, dx, dy) & ~edges;
+        m.shift = 64 - popCount(m.mask);
+        m.magic = 0;
+        m.attacks = next;
+
+        /* enumerate all subsets of the mask (Carry-Rippler trick) */
+        int size = 0;
+        Bitboard b = 0;
+        do {
+#ifdef USE_PEXT
+            m.attacks[magicIndex(m, b)] = slidingAttacks(sq, b, 4, dx, dy);
+#else
+            occupancy[size] = b;
+            reference[size] = slidingAttacks(sq, b, 4, dx, dy);
+#endif
+            size++;
+            b = (b - m.mask) & m.mask;
+        } while (b);
+
+        next += size;
+
+#ifndef USE_PEXT
+        /* try sparse random magics until one maps every subset without destructive collisions */
+        uint64_t state = seeds[rankOf(sq) - 1];
+        for (int i = 0; i < size; ) {
+            do {
+                m.magic = randomNumber(state) & randomNumber(state) & randomNumber(state);
+            } while (popCount((m.magic * m.mask) >> 56) < 6);
+
+            for (attempt++, i = 0; i < size; i++) {
+                unsigned index = magicIndex(m, occupancy[i]);
+
+                if (epoch[index] < attempt) {
+                    epoch[index] = attempt;
+                    m.attacks[index] = reference[i];
+                } else if (m.attacks[index] != reference[i]) {
+                    break;
+                }
+            }
+        }
+#endif
+    }
+}
+
+void initBitboards() {
+    initMagics(rookTable, rookMagics, rook_dx, rook_dy);
+    initMagics(bishopTable, bishopMagics, bishop_dx, bishop_dy);
+
+    static const int pawn_dx[2][2] = {{-1, -1}, {1, 1}};
+    static const int pawn_dy[2][2] = {{-1,  1}, {-1, 1}};
+
+    for (int sq = 0; sq < SQUARES; sq++) {
+        knightAttacks[sq] = stepAttacks(sq, 8, knight_dx, knight_dy);
+        kingAttacks[sq] = stepAttacks(sq, 8, dx, dy);
+        pawnAttacks[BLACK][sq] = stepAttacks(sq, 2, pawn_dx[BLACK], pawn_dy[BLACK]);
+        pawnAttacks[WHITE][sq] = stepAttacks(sq, 2, pawn_dx[WHITE], pawn_dy[WHITE]);
+    }
+
+    for (int s1 = 0; s1 < SQUARES; s1++) {
+        for (int s2 = 0; s2 < SQUARES; s2++) {
+            betweenBB[s1][s2] = lineBB[s1][s2] = 0;
+            if (s1 == s2)
+                continue;
+
+            if (bishopAttacks(s1, 0) & squareBB(s2)) {
+                betweenBB[s1][s2] = bishopAttacks(s1, squareBB(s2)) & bishopAttacks(s2, squareBB(s1));
+                lineBB[s1][s2] = (bishopAttacks(s1, 0) & bishopAttacks(s2, 0)) | squareBB(s1) | squareBB(s2);
+            } else if (rookAttacks(s1, 0) & squareBB(s2)) {
+                betweenBB[s1][s2] = rookAttacks(s1, squareBB(s2)) & rookAttacks(s2, squareBB(s1));
+                lineBB[s1][s2] = (rookAttacks(s1, 0) & rookAttacks(s2, 0)) | squareBB(s1) | squareBB(s2);
+            }
+        }
+    }
+}
+
+std::string squareToString(int sq) {
+    std::string str;
+    str += (char)('a' + fileOf(sq) - 1);
+    str += (char)('0' + rankOf(sq));
+    return str;
+}
+
+int stringToSquare(const std::string &str) {
+    return makeSquare(str[1] - '0', str[0] - 'a' + 1);
+}
@@ -0,0 +1,136 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+#include <bits/stdc++.h>
+
+#ifdef USE_PEXT
+#include <immintrin.h>
+#endif
+
+#include "PlaySide.h"
+
+/* one bit per square, square index = (rank - 1) * 8 + (file - 1), so a1 = 0, h1 = 7, a8 = 56 */
+typedef uint64_t Bitboard;
+
+#define SQUARES 64
+#define NO_SQUARE 64
+
+#define RANK_1 0x00000000000000FFULL
+#define RANK_2 0x000000000000FF00ULL
+#define RANK_7 0x00FF000000000000ULL
+#define RANK_8 0xFF00000000000000ULL
+
+#define FILE_A 0x0101010101010101ULL
+#define FILE_H 0x8080808080808080ULL
+
+/* pawn geometry of each side: square increment of a push, rank of the double push, promotion rank */
+constexpr int pawnPush(PlaySide playSide) {
+    return (playSide == WHITE) ? 8 : -8;
+}
+
+constexpr Bitboard doublePushRank(PlaySide playSide) {
+    return (playSide == WHITE) ? RANK_2 : RANK_7;
+}
+
+constexpr Bitboard promotionRank(PlaySide playSide) {
+    return (playSide == WHITE) ? RANK_8 : RANK_1;
+}
+
+/*
+  Sliding attacks lookup for one square: the relevant occupancy (the squares on the piece's rays,
+  without the board edges) is mapped to an index in the attacks table, either with a magic
+  multiplication or, when built with PEXT=1 (USE_PEXT), with the BMI2 pext instruction.
+ */
+typedef struct {
+    Bitboard mask;      /* relevant occupancy */
+    Bitboard magic;     /* magic multiplier, unused with USE_PEXT */
+    Bitboard *attacks;  /* attacks for every subset of mask */
+    unsigned shift;     /* 64 - popCount(mask) */
+} Magic;
+
+extern Magic rookMagics[SQUARES];
+extern Magic bishopMagics[SQUARES];
+
+extern Bitboard knightAttacks[SQUARES];
+extern Bitboard kingAttacks[SQUARES];
+extern Bitboard pawnAttacks[2][SQUARES];  /* pawnAttacks[playSide][sq] - squares attacked by a pawn of playSide */
+extern Bitboard betweenBB[SQUARES][SQUARES];  /* squares strictly between two squares on the same line, 0 otherwise */
+extern Bitboard lineBB[SQUARES][SQUARES];     /* the whole line through two squares (edge to edge), 0 if not aligned */
+
+/**
+ * Precompute the attack tables. Must be called once, before any other function in this file.
+*/
+void initBitboards();
+
+inline unsigned magicIndex(const Magic &m, Bitboard occupied) {
+#ifdef USE_PEXT
+    return _pext_u64(occupied, m.mask);
+#else
+    return ((occupied & m.mask) * m.magic) >> m.shift;
+#endif
+}
+
+inline Bitboard rookAttacks(int sq, Bitboard occupied) {
+    const Magic &m = rookMagics[sq];
+    return m.attacks[magicIndex(m, occupied)];
+}
+
+inline Bitboard bishopAttacks(int sq, Bitboard occupied) {
+    const Magic &m = bishopMagics[sq];
+    return m.attacks[magicIndex(m, occupied)];
+}
+
+inline Bitboard queenAttacks(int sq, Bitboard occupied) {
+    return rookAttacks(sq, occupied) | bishopAttacks(sq, occupied);
+}
+
+constexpr Bitboard squareBB(int sq) {
+    return 1ULL << sq;
+}
+
+constexpr int makeSquare(int rank, int file) {
+    return (rank - 1) * 8 + (file - 1);
+}
+
+/* 1-indexed rank and file, matching the coordinate notation */
+constexpr int rankOf(int sq) {
+    return (sq >> 3) + 1;
+}
+
+constexpr int fileOf(int sq) {
+    return (sq & 7) + 1;
+}
+
+/* number of king moves between two squares */
+inline int distance(int a, int b) {
+    return std::max(abs(rankOf(a) - rankOf(b)), abs(fileOf(a) - fileOf(b)));
+}
+
+inline int popCount(Bitboard b) {
+    return __builtin_popcountll(b);
+}
+
+inline int lsb(Bitboard b) {
+    return __builtin_ctzll(b);
+}
+
+/**
+ * Remove the least significant set bit of b.
+ * @returns index of the removed bit
+*/
+inline int popLsb(Bitboard &b) {
+    int sq = lsb(b);
+    b &= b - 1;
+    return sq;
+}
+
+/**
+ * Generate a string representation of sq, in coordinate notation (e.g. b4, e8).
+*/
+std::string squareToString(int sq);
+
+/**
+ * Parse a square from its coordinate notation (e.g. a1, f5).
+*/
+int stringToSquare(const std::string &str);
+
+#endif
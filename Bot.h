@@ -3,160 +3,123 @@
 #include <bits/stdc++.h>
 
 #include "Move.h"
+#include "PackedMove.h"
 #include "PlaySide.h"
+#include "Position.h"
+#include "SearchContext.h"
+#include "TimeManager.h"
+#include "TranspositionTable.h"
 
-#define BOARD_SIZE 8
-#define MAX_DEPTH 4 
-
-#define DIRECTIONS 8
-#define ROOK_DIRECTIONS 4
-#define BISHOP_DIRECTIONS 4
-#define KNIGHT_DIRECTIONS 8
-
-#define INF 1000000000
-
-enum BoardPiece { 
-    WHITE_PAWN = 1, WHITE_ROOK = 2, WHITE_BISHOP = 3,
-    WHITE_KNIGHT = 4, WHITE_QUEEN = 5, WHITE_KING = 6,
-    BLACK_PAWN = 7, BLACK_ROOK = 8, BLACK_BISHOP = 9,
-    BLACK_KNIGHT = 10, BLACK_QUEEN = 11, BLACK_KING = 12,
-    EMPTY = 0
-};
-
-enum PiecePoints {
-    POINTS_PAWN = 1, POINTS_KNIGHT = 3, POINTS_BISHOP = 3,
-    POINTS_ROOK = 5, POINTS_QUEEN = 9, POINTS_KING = 100
-};
-
-enum Direction {
-    UPPER_LEFT = 0, UP = 1, UPPER_RIGHT = 2,
-    RIGHT = 3,
-    LOWER_RIGHT = 4, DOWN = 5, LOWER_LEFT = 6,
-    LEFT = 7
-};
+#define MAX_THREADS 64
 
 enum PlayMode {
-    NORMAL_MODE = 0, FORCE_MODE = 1
+    NORMAL_MODE = 0, FORCE_MODE = 1, ANALYZE_MODE = 2
 };
 
-/* all possible directions, also used by the queen, king */
-const int dx[] = {-1, -1, -1,  0,  1,  1,  1,  0};
-const int dy[] = {-1,  0,  1,  1,  1,  0, -1, -1};
-
-const int knight_dx[] = {-2, -2, -1,  1,  2,  2,  1, -1};
-const int knight_dy[] = {-1,  1,  2,  2,  1, -1, -2, -2};
-
-const int rook_dx[] = {-1, 0, 1,  0};
-const int rook_dy[] = { 0, 1, 0, -1};
-
-const int bishop_dx[] = {-1,  1,  1, -1};
-const int bishop_dy[] = {-1, -1,  1, 1};
-
-typedef struct {
-    int x, y;
-} position;
-
-typedef struct {
-    position pos;
-    int dir;
-} dir;
-
 class Bot {
  private:
     static const std::string BOT_NAME;
 
     PlaySide botPlaySide;
-    PlaySide sideToMoveNext;
-
-    bool castlePossible[2][2];  /* 0 - Queen side castle, 1 - King side castle
-                                   castlePossible[PlaySide::WHITE][] - for WHITE's castling rights
-                                   castlePossible[PlaySide::BLACK][] - for BLACK's castling rights */
-
-    Move *nextMove; /* next move generated */
-    Move *lastRecordedMove; /* last recorded move */
-
-    int moveCount; /* number of moves (from the beginning of a game) without any captured pieces or pawns moved */
 
     PlayMode mode;
 
-    int board[BOARD_SIZE + 1][BOARD_SIZE + 1];
-
-    int pool[2][5];  /* number of pieces captured and can be dropped */
-                     /* pool[PlaySide::BLACK] - black's pool
-                        pool[PlaySide::WHITE] - white's pool */
-
-
-    void initBoard();
-
-    std::string toString(position pos);
-
-    position getMovePosition(std::optional<std::string> pos);
+    Position position;  /* position of the game, updated with every recorded move */
 
-    void movePiece(int (&board)[BOARD_SIZE+1][BOARD_SIZE+1], position src, position dst, PlaySide playside);
+    TranspositionTable *transpositionTable;  /* kept for the whole game, shared by the search threads */
 
-    int getBoardPiece(Piece piece, PlaySide playSide);
+    std::vector<SearchContext*> searchContexts;  /* one per search thread, the first for the main thread */
 
-    PlaySide getPlaySide(int value);
+    std::atomic<bool> stopSignal;  /* raised to stop the helper threads */
 
-    PlaySide getOpponentPlaySide(PlaySide playSide);
+    TimeManager timeManager;  /* time control set by xboard */
 
-    position getKingPosition(int (&board)[BOARD_SIZE+1][BOARD_SIZE+1], PlaySide sideToMove);
+    bool post;  /* print thinking output (xboard post / nopost) */
 
-    bool isPositionValid(position pos);
+    bool ponder;            /* think on the opponent's time (xboard hard / easy) */
+    PackedMove ponderMove;  /* opponent's move the bot is pondering on, NO_MOVE when not pondering */
+    bool ponderHit;         /* the opponent played ponderMove, the ponder search now runs on the bot's time */
 
-    bool inCheck(int (&board)[BOARD_SIZE+1][BOARD_SIZE+1], PlaySide playSide);
+    std::thread backgroundThread;  /* ponder or analysis search, running while xboard commands are read */
+    Position backgroundRoot;       /* position searched by backgroundThread */
+    PackedMove backgroundResult;   /* best move of the background search, once backgroundThread is joined */
 
-    bool landsInCheck(int (&board)[BOARD_SIZE+1][BOARD_SIZE+1], position src, position dst, BoardPiece replc);
+    PackedMove search(const Position &root, bool thinking);
 
-    bool isAttacked(position src, position dst);
+    void startBackgroundSearch(const Position &root);
 
-    Piece getPiece(int value);
+    void startPondering(PackedMove expectedMove);
 
-    int getPiecePoints(int value);
-
-    bool spaceForCastle(int (&board)[BOARD_SIZE+1][BOARD_SIZE+1], PlaySide playSide, int type);
-
-    bool castle(int (&board)[BOARD_SIZE+1][BOARD_SIZE+1], PlaySide playSide);
-
-    void defendCheck(int (&board)[BOARD_SIZE+1][BOARD_SIZE+1], PlaySide sideToMove);
-
-    std::vector<Move*> generateAllMoves(int (&board)[BOARD_SIZE+1][BOARD_SIZE+1], PlaySide playSide);
-
-    bool enPassantRights(int (&board)[BOARD_SIZE+1][BOARD_SIZE+1], position src, position dst);
+ public:
+    static std::string moveToString(Move* move);
 
-    void pushPieceMoves(int (&board)[BOARD_SIZE+1][BOARD_SIZE+1], position src, std::vector<Move*> &moves, \
-                        int directions, const int dx[], const int dy[]);
+    PlaySide getBotPlaySide();
 
-    int evaluate(int (&board)[BOARD_SIZE+1][BOARD_SIZE+1]);
+    void setBotPlaySide(PlaySide playSide);
 
-    int getPiecePointsDiff(int (&board)[BOARD_SIZE+1][BOARD_SIZE+1]);
+    void setMode(PlayMode playMode);
 
-    int minimax(int (&board)[BOARD_SIZE+1][BOARD_SIZE+1], int depth);
+    TimeManager& getTimeManager();
 
-    int makeMove(Move *move, int (&board)[BOARD_SIZE+1][BOARD_SIZE+1], PlaySide playSide);
+    const Position& getPosition();
 
-    void undoMove(Move *move, int (&board)[BOARD_SIZE+1][BOARD_SIZE+1], int captured, PlaySide playSide);
+    /**
+     * Set the number of search threads (xboard "cores").
+     */
+    void setThreads(int threads);
 
- public:
-    static std::string moveToString(Move* move);
+    /**
+     * Enable or disable pondering (xboard "hard" / "easy").
+     */
+    void setPonder(bool ponder);
 
-    bool positionEquals(position p, position q);
+    /**
+     * Enable or disable thinking output (xboard "post" / "nopost"); always on in analyze mode.
+     */
+    void setPost(bool post);
 
-    PlaySide getBotPlaySide();
+    /**
+     * Search the current position, in the background and without limits, printing the result
+     * of every iteration (xboard "analyze").
+     */
+    void startAnalysis();
 
-    void setBotPlaySide(PlaySide playSide);
+    /**
+     * Print the progress of the analysis (xboard "."), as a stat01 line.
+     */
+    void printStatus();
 
-    void setMode(PlayMode playMode);
+    /**
+     * Abort the ponder or analysis search, if any; needed before anything but the opponent's move
+     * changes the game.
+     */
+    void stopSearching();
 
     Bot();
 
+    ~Bot();
+
     /**
      * Record move (either by enemy in normal mode, or by either side
      * in force mode) in custom structures
      * @param move received move
-     * @param sideToMode side to move
      */
-    void recordMove(Move* move, PlaySide sideToMove);
+    void recordMove(PackedMove move);
+
+    /**
+     * Replace the position of the game (xboard "setboard").
+     * @param fen crazyhouse FEN of the new position
+     * @return false if the FEN is not valid, the position is then left unchanged
+     */
+    bool setBoard(const std::string &fen);
+
+    /**
+     * Pack a move received from xboard, flagging castles and en passant captures
+     * according to the current board
+     * @param move received move
+     * @return the packed move
+     */
+    PackedMove parseMove(Move* move);
 
     /**
      * Calculates next move, in response to enemyMove
@@ -165,7 +128,7 @@ class Bot {
      *                  move has been recorded in force mode
      * @return your move
      */
-    Move* calculateNextMove();
+    PackedMove calculateNextMove();
 
     static std::string getBotName();
 };
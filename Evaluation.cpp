@@ -0,0 +1,101 @@
+#include "Evaluation.h"
+
+#include <bits/stdc++.h>
+
+#include "Position.h"
+
+int pieceValue[6];
+int pieceSquareScore[13][SQUARES];
+int pocketScore[5];
+
+/* piece-square bonuses from White's point of view, rank 8 on the first row */
+static const int pawnTable[SQUARES] = {
+      0,   0,   0,   0,   0,   0,   0,   0,
+     60,  60,  60,  60,  60,  60,  60,  60,
+     30,  30,  35,  40,  40,  35,  30,  30,
+     10,  10,  20,  30,  30,  20,  10,  10,
+      5,   5,  10,  25,  25,  10,   5,   5,
+      0,   0,   0,  10,  10,   0,   0,   0,
+      5,   5,   5, -10, -10,   5,   5,   5,
+      0,   0,   0,   0,   0,   0,   0,   0
+};
+
+static const int knightTable[SQUARES] = {
+    -40, -25, -20, -20, -20, -20, -25, -40,
+    -25,  -5,   5,  10,  10,   5,  -5, -25,
+    -20,   5,  15,  20,  20,  15,   5, -20,
+    -20,  10,  20,  25,  25,  20,  10, -20,
+    -20,   5,  20,  25,  25,  20,   5, -20,
+    -20,   5,  15,  15,  15,  15,   5, -20,
+    -25,  -5,   0,   5,   5,   0,  -5, -25,
+    -40, -25, -20, -20, -20, -20, -25, -40
+};
+
+static const int bishopTable[SQUARES] = {
+    -20, -10, -10, -10, -10, -10, -10, -20,
+    -10,   0,   0,   0,   0,   0,   0, -10,
+    -10,   0,   5,  10,  10,   5,   0, -10,
+    -10,   5,   5,  10,  10,   5,   5, -10,
+    -10,   0,  10,  10,  10,  10,   0, -10,
+    -10,  10,  10,  10,  10,  10,  10, -10,
+    -10,   5,   0,   0,   0,   0,   5, -10,
+    -20, -10, -10, -10, -10, -10, -10, -20
+};
+
+static const int rookTable[SQUARES] = {
+      0,   0,   0,   0,   0,   0,   0,   0,
+     10,  15,  15,  15,  15,  15,  15,  10,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+      0,   0,   0,   5,   5,   0,   0,   0
+};
+
+static const int queenTable[SQUARES] = {
+    -20, -10, -10,  -5,  -5, -10, -10, -20,
+    -10,   0,   0,   0,   0,   0,   0, -10,
+    -10,   0,   5,   5,   5,   5,   0, -10,
+     -5,   0,   5,   5,   5,   5,   0,  -5,
+     -5,   0,   5,   5,   5,   5,   0,  -5,
+    -10,   0,   5,   5,   5,   5,   0, -10,
+    -10,   0,   0,   0,   0,   0,   0, -10,
+    -20, -10, -10,  -5,  -5, -10, -10, -20
+};
+
+/* with drops, a king away from its shelter is quickly mated */
+static const int kingTable[SQUARES] = {
+    -80, -80, -80, -90, -90, -80, -80, -80,
+    -80, -80, -80, -90, -90, -80, -80, -80,
+    -70, -70, -70, -80, -80, -70, -70, -70,
+    -60, -60, -60, -70, -70, -60, -60, -60,
+    -50, -50, -50, -60, -60, -50, -50, -50,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+      0,   0, -10, -20, -20, -10,   0,   0,
+     20,  30,  10,   0,   0,  10,  30,  20
+};
+
+void initEvaluation() {
+    static const int values[] = {POINTS_PAWN, POINTS_ROOK, POINTS_BISHOP, POINTS_KNIGHT, POINTS_QUEEN, POINTS_KING};
+    static const int *tables[] = {pawnTable, rookTable, bishopTable, knightTable, queenTable, kingTable};
+
+    for (int piece = PAWN; piece <= KING; piece++) {
+        pieceValue[piece] = values[piece];
+
+        for (int sq = 0; sq < SQUARES; sq++) {
+            int whiteIndex = (8 - rankOf(sq)) * 8 + fileOf(sq) - 1;
+            int blackIndex = (rankOf(sq) - 1) * 8 + fileOf(sq) - 1;
+
+            pieceSquareScore[Position::getBoardPiece(Piece(piece), WHITE)][sq] = values[piece] + tables[piece][whiteIndex];
+            pieceSquareScore[Position::getBoardPiece(Piece(piece), BLACK)][sq] = values[piece] + tables[piece][blackIndex];
+        }
+    }
+
+    for (int sq = 0; sq < SQUARES; sq++)
+        pieceSquareScore[EMPTY][sq] = 0;
+
+    /* a piece in hand can be dropped where it hurts the most */
+    for (int piece = PAWN; piece <= QUEEN; piece++)
+        pocketScore[piece] = values[piece] + values[piece] / 10;
+}
@@ -0,0 +1,28 @@
+#ifndef EVALUATION_H
+#define EVALUATION_H
+#include <bits/stdc++.h>
+
+#include "Bitboard.h"
+#include "Piece.h"
+
+/* centipawns */
+enum PiecePoints {
+    POINTS_PAWN = 100, POINTS_KNIGHT = 300, POINTS_BISHOP = 300,
+    POINTS_ROOK = 500, POINTS_QUEEN = 900, POINTS_KING = 10000
+};
+
+/*
+  Evaluation terms that only depend on a single piece, so that Position can keep their sums
+  up to date in O(1) on every change: the value of a piece on a square (material plus
+  piece-square bonus) and the value of a piece in a pocket.
+ */
+extern int pieceValue[6];                 /* pieceValue[piece] - material value */
+extern int pieceSquareScore[13][SQUARES]; /* pieceSquareScore[BoardPiece][sq], 0 for EMPTY */
+extern int pocketScore[5];                /* pocketScore[piece] - value of a piece in hand */
+
+/**
+ * Fill the score tables. Must be called once, before any Position is created.
+*/
+void initEvaluation();
+
+#endif
@@ -2,10 +2,14 @@
 
 #include <cassert>
 
+#include "Bench.h"
 #include "Bot.h"
+#include "Evaluation.h"
 #include "Move.h"
+#include "Perft.h"
 #include "Piece.h"
 #include "PlaySide.h"
+#include "Zobrist.h"
 
 static PlaySide sideToMove;
 static PlaySide engineSide;
@@ -29,10 +33,11 @@ static std::string constructFeaturesPayload() {
           << " san=0"
           << " reuse=0"
           << " usermove=1"
-          << " analyze=0"
+          << " analyze=1"
           << " ping=0"
-          << " setboard=0"
-          << " level=0"
+          << " setboard=1"
+          << " time=1"
+          << " smp=1"
           << " variants=\"crazyhouse\""
           << " name=\"" << Bot::getBotName() << "\" myname=\""
           << Bot::getBotName() << "\" done=1\n";
@@ -149,13 +154,30 @@ static Move* deserializeMove(std::string s) {
   return Move::moveTo(s.substr(0, 2), s.substr(2, 4));
 }
 
+/* commands that leave a ponder or analysis search running: the opponent's move and the clocks sent with it,
+   status requests and options that do not affect the search */
+static bool keepsSearching(const std::string &command) {
+  static const std::set<std::string> commands = {"usermove", "time", "otim", ".", "post", "nopost", "hard", "easy"};
+  return commands.count(command) > 0;
+}
+
+/* xboard sends the base time of "level" as minutes or minutes:seconds */
+static int64_t parseBaseTime(const std::string &s) {
+  size_t colon = s.find(':');
+  if (colon == std::string::npos)
+    return (int64_t)(atof(s.c_str()) * 60000);
+
+  return atoll(s.substr(0, colon).c_str()) * 60000 + (int64_t)(atof(s.substr(colon + 1).c_str()) * 1000);
+}
+
 class EngineComponents {
  private:
   enum EngineState {
     HANDSHAKE_DONE = 0,
     RECV_NEW = 1,
     PLAYING = 2,
-    FORCE_MODE = 3
+    FORCE_MODE = 3,
+    ANALYZE_MODE = 4
   };
   void emitMove(Move* move) {
     if (move->isDropIn() || move->isNormal() || move->isPromotion())
@@ -169,6 +191,9 @@ class EngineComponents {
   std::optional<std::string> bufferedCmd;
   std::istream& scanner;
   bool isStarted;
+  int cores;
+  bool ponder;
+  bool post;
 
   void performHandshake() {
       /* Await start command ("xboard") */
@@ -204,6 +229,9 @@ class EngineComponents {
 
       engineSide = PlaySide::BLACK;
       bot.value()->setMode(PlayMode::NORMAL_MODE);
+      bot.value()->setThreads(cores);
+      bot.value()->setPonder(ponder);
+      bot.value()->setPost(post);
   }
 
   void enterForceMode() {
@@ -212,6 +240,20 @@ class EngineComponents {
       bot.value()->setMode(PlayMode::FORCE_MODE);
   }
 
+  void enterAnalyzeMode() {
+    state = EngineState::ANALYZE_MODE;
+
+    bot.value()->setMode(PlayMode::ANALYZE_MODE);
+    bot.value()->startAnalysis();
+  }
+
+  void exitAnalyzeMode() {
+    /* xboard left force mode to analyze, and is back to it */
+    state = EngineState::FORCE_MODE;
+
+    bot.value()->setMode(PlayMode::FORCE_MODE);
+  }
+
   void leaveForceMode() {
     /* Called upon receiving "go" */
     state = EngineState::PLAYING;
@@ -226,7 +268,7 @@ class EngineComponents {
     bot.value()->setMode(PlayMode::NORMAL_MODE);
 
     /* Make next move (go is issued when it's the bot's turn) */
-    Move *move = bot.value()->calculateNextMove();
+    Move *move = bot.value()->calculateNextMove().toMove();
     emitMove(move);
 
     delete move;
@@ -235,14 +277,19 @@ class EngineComponents {
 
   void processIncomingMove(Move *move) {
     if (state.value() == FORCE_MODE) {
-      bot.value()->recordMove(move, sideToMove);
+      bot.value()->recordMove(bot.value()->parseMove(move));
+      toggleSideToMove();
+
+    } else if (state.value() == ANALYZE_MODE) {
+      bot.value()->recordMove(bot.value()->parseMove(move));
       toggleSideToMove();
 
+      bot.value()->startAnalysis();
     } else if (state.value() == PLAYING || state.value() == RECV_NEW) {
-      bot.value()->recordMove(move, sideToMove);
+      bot.value()->recordMove(bot.value()->parseMove(move));
       toggleSideToMove();
 
-      Move *response = bot.value()->calculateNextMove();
+      Move *response = bot.value()->calculateNextMove().toMove();
       emitMove(response);
 
       delete response;
@@ -258,6 +305,9 @@ class EngineComponents {
     bufferedCmd = {};
     scanner.rdbuf()->pubsetbuf(0, 0);
     isStarted = false;
+    cores = 1;
+    ponder = false;
+    post = false;
   }
 
   void executeOneCommand() {
@@ -273,10 +323,18 @@ class EngineComponents {
     std::string command;
     getline(command_stream, command, ' ');
 
+    if (bot.has_value() && !keepsSearching(command))
+      bot.value()->stopSearching();
+
     if (command == "quit") {
       exit(0);
     } else if (command == "new") {
+      /* analysis goes on, from the start position */
+      bool analyzing = state.has_value() && state.value() == ANALYZE_MODE;
+
       newGame();
+      if (analyzing)
+        enterAnalyzeMode();
     } else if (command == "force") {
       enterForceMode();
     } else if (command == "go") {
@@ -288,11 +346,92 @@ class EngineComponents {
 
       processIncomingMove(incomingMove);
       delete incomingMove;
+    } else if ((command == "perft" || command == "divide") && bot.has_value()) {
+      /* move generator test on the current position: perft <depth>, divide <depth> */
+      std::string value;
+      command_stream >> value;
+
+      if (atoi(value.c_str()) > 0)
+        Perft(cores).run(bot.value()->getPosition(), atoi(value.c_str()), command == "divide", std::cout);
+    } else if (command == "bench") {
+      /* search speed test: bench [depth] [threads] */
+      std::string depth, threads;
+      command_stream >> depth >> threads;
+
+      runBench(atoi(depth.c_str()) > 0 ? atoi(depth.c_str()) : BENCH_DEPTH,
+               std::clamp(atoi(threads.c_str()), 1, MAX_THREADS), std::cout);
+    } else if (command == "setboard" && bot.has_value()) {
+      std::string fen;
+      getline(command_stream, fen);
+
+      if (bot.value()->setBoard(fen)) {
+        sideToMove = bot.value()->getPosition().sideToMove;
+        if (state.value() == ANALYZE_MODE)
+          bot.value()->startAnalysis();
+      } else {
+        std::cout << "tellusererror Illegal position\n";
+      }
+    } else if (command == "analyze" && bot.has_value()) {
+      enterAnalyzeMode();
+    } else if (command == "exit" && state.has_value() && state.value() == ANALYZE_MODE) {
+      exitAnalyzeMode();
+    } else if (command == "." && bot.has_value()) {
+      bot.value()->printStatus();
+    } else if (command == "post" || command == "nopost") {
+      /* thinking output, kept for the next games too */
+      post = (command == "post");
+      if (bot.has_value())
+        bot.value()->setPost(post);
+    } else if (command == "hard" || command == "easy") {
+      /* pondering, kept for the next games too */
+      ponder = (command == "hard");
+      if (bot.has_value())
+        bot.value()->setPonder(ponder);
+    } else if (command == "cores") {
+      std::string value;
+      command_stream >> value;
+
+      /* kept for the next games too */
+      cores = std::max(1, atoi(value.c_str()));
+      if (bot.has_value())
+        bot.value()->setThreads(cores);
+    } else if (bot.has_value()) {
+      TimeManager &timeManager = bot.value()->getTimeManager();
+      std::string mps, base, inc, value;
+
+      if (command == "level") {
+        command_stream >> mps >> base >> inc;
+        timeManager.setLevel(atoi(mps.c_str()), parseBaseTime(base), (int64_t)(atof(inc.c_str()) * 1000));
+      } else if (command == "st") {
+        command_stream >> value;
+        timeManager.setFixedTime((int64_t)(atof(value.c_str()) * 1000));
+      } else if (command == "sd") {
+        command_stream >> value;
+        timeManager.setDepthLimit(atoi(value.c_str()));
+      } else if (command == "time") {
+        command_stream >> value;
+        timeManager.setEngineTime(atoll(value.c_str()));
+      } else if (command == "otim") {
+        command_stream >> value;
+        timeManager.setOpponentTime(atoll(value.c_str()));
+      }
     }
   }
 };
 
-int main() {
+int main(int argc, char **argv) {
+  initBitboards();
+  initZobrist();
+  initEvaluation();
+  initSearch();
+
+  /* ./Main bench [depth] [threads] - run the search speed test and exit */
+  if (argc > 1 && std::string(argv[1]) == "bench") {
+    runBench(argc > 2 && atoi(argv[2]) > 0 ? atoi(argv[2]) : BENCH_DEPTH,
+             argc > 3 ? std::clamp(atoi(argv[3]), 1, MAX_THREADS) : 1, std::cout);
+    return 0;
+  }
+
   EngineComponents* engine = new EngineComponents();
   engine->performHandshake();
 
@@ -0,0 +1,26 @@
+#ifndef MOVE_LIST_H
+#define MOVE_LIST_H
+
+#include "PackedMove.h"
+
+/* upper bound on the number of moves in a crazyhouse position: up to 5 piece types can be
+   dropped on every empty square, on top of the moves of the pieces on the board */
+#define MAX_MOVES 1024
+
+/* fixed-capacity list of moves, meant to live on the stack or in a preallocated search frame */
+class MoveList {
+ public:
+  PackedMove moves[MAX_MOVES];
+  int size;
+
+  MoveList() : size(0) {}
+
+  void push(PackedMove move) { moves[size++] = move; }
+  void clear() { size = 0; }
+  bool empty() const { return size == 0; }
+
+  PackedMove& operator[](int i) { return moves[i]; }
+  const PackedMove& operator[](int i) const { return moves[i]; }
+};
+
+#endif
@@ -0,0 +1,45 @@
+#include "PackedMove.h"
+
+#include <bits/stdc++.h>
+
+#include "Bitboard.h"
+
+Move* PackedMove::toMove() const {
+  if (*this == NO_MOVE)
+    return Move::resign();
+
+  if (isDropIn())
+    return Move::dropIn(squareToString(getDestination()), getReplacement());
+
+  if (isPromotion())
+    return Move::promote(squareToString(getSource()), squareToString(getDestination()), getReplacement());
+
+  return Move::moveTo(squareToString(getSource()), squareToString(getDestination()));
+}
+
+PackedMove PackedMove::fromMove(Move *move) {
+  if (move->isDropIn())
+    return dropIn(stringToSquare(move->getDestination().value()), move->getReplacement().value());
+
+  if (move->isPromotion())
+    return promote(stringToSquare(move->getSource().value()), stringToSquare(move->getDestination().value()),
+                   move->getReplacement().value());
+
+  if (move->isNormal())
+    return moveTo(stringToSquare(move->getSource().value()), stringToSquare(move->getDestination().value()));
+
+  return NO_MOVE;
+}
+
+std::string PackedMove::toString() const {
+  static const char pieceCodes[] = {'p', 'r', 'b', 'n', 'q', 'k'};
+
+  if (isDropIn())
+    return std::string(1, toupper(pieceCodes[getReplacement()])) + "@" + squareToString(getDestination());
+
+  std::string str = squareToString(getSource()) + squareToString(getDestination());
+  if (isPromotion())
+    str += pieceCodes[getReplacement()];
+
+  return str;
+}
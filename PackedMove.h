@@ -0,0 +1,86 @@
+#ifndef PACKED_MOVE_H
+#define PACKED_MOVE_H
+
+#include <bits/stdc++.h>
+
+#include "Move.h"
+#include "Piece.h"
+
+/* kind of move, stored in the upper 4 bits of a PackedMove */
+enum MoveType {
+  NORMAL_MOVE = 0, EN_PASSANT = 1, CASTLE = 2, DROP_IN = 3,
+  PROMOTION = 4  /* PROMOTION + (piece - ROOK), for promotions to ROOK .. QUEEN */
+};
+
+/*
+  Internal move representation used by the engine, packed in 16 bits:
+  bits 0-5   destination square
+  bits 6-11  source square, or the dropped Piece for drop-ins
+  bits 12-15 MoveType
+  Textual Moves are only built at the xboard boundary (see toMove(), Position::parseMove()).
+ */
+class PackedMove {
+ public:
+  uint16_t data;
+
+  PackedMove() = default;
+  constexpr explicit PackedMove(uint16_t _data) : data(_data) {}
+
+  static PackedMove moveTo(int source, int destination, MoveType type = NORMAL_MOVE) {
+    return PackedMove(destination | (source << 6) | (type << 12));
+  }
+
+  static PackedMove promote(int source, int destination, Piece replacement) {
+    return PackedMove(destination | (source << 6) | ((PROMOTION + replacement - ROOK) << 12));
+  }
+
+  static PackedMove dropIn(int destination, Piece replacement) {
+    return PackedMove(destination | (replacement << 6) | (DROP_IN << 12));
+  }
+
+  int getDestination() const { return data & 0x3F; }
+  int getSource() const { return (data >> 6) & 0x3F; }
+  MoveType getType() const { return MoveType(data >> 12); }
+
+  /**
+   * Get the dropped piece (for drop-ins) or the piece a pawn promotes to (for promotions).
+   */
+  Piece getReplacement() const {
+    return isDropIn() ? Piece(getSource()) : Piece(getType() - PROMOTION + ROOK);
+  }
+
+  /**
+   * Checks whether the move is an usual move/capture (including castles and en passant)
+   * @return true if move is NOT a drop-in or promotion, false otherwise
+   */
+  bool isNormal() const { return getType() < DROP_IN; }
+  bool isPromotion() const { return getType() >= PROMOTION; }
+  bool isDropIn() const { return getType() == DROP_IN; }
+  bool isEnPassant() const { return getType() == EN_PASSANT; }
+  bool isCastle() const { return getType() == CASTLE; }
+
+  bool operator==(const PackedMove &other) const { return data == other.data; }
+  bool operator!=(const PackedMove &other) const { return data != other.data; }
+
+  /**
+   * Build the textual Move sent to xboard.
+   * @return a new Move, Move::resign() for NO_MOVE
+   */
+  Move* toMove() const;
+
+  /**
+   * Pack a textual Move received from xboard. Castles and en passant captures cannot be told
+   * apart from normal moves without looking at the board, they are flagged by Position::parseMove().
+   */
+  static PackedMove fromMove(Move *move);
+
+  /**
+   * Generate a string representation of the move, in coordinate notation (e.g. e2e4, e7e8q, N@f3).
+   */
+  std::string toString() const;
+};
+
+/* a1a1 is never a valid move */
+#define NO_MOVE PackedMove(0)
+
+#endif
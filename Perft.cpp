@@ -0,0 +1,111 @@
+#include "Perft.h"
+
+#include <bits/stdc++.h>
+
+Perft::Perft(int threads, size_t hashMegabytes) {
+    this->threads = std::max(threads, 1);
+
+    table = nullptr;
+    mask = 0;
+
+    if (hashMegabytes > 0) {
+        uint64_t size = 1;
+        while (size * 2 * sizeof(PerftSlot) <= hashMegabytes * 1024 * 1024)
+            size *= 2;
+
+        table = new PerftSlot[size];
+        mask = size - 1;
+
+        for (uint64_t i = 0; i < size; i++) {
+            table[i].check.store(0, std::memory_order_relaxed);
+            table[i].count.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+Perft::~Perft() {
+    delete[] table;
+}
+
+/**
+ * Count the leaf nodes of the subtree of position, with makeMove / undoMove.
+ * @tparam Us side to move
+ * @param position position, the same when the function returns
+ * @param depth remaining depth, at least 1
+ * @returns the number of leaf nodes
+*/
+template <PlaySide Us>
+uint64_t Perft::count(Position &position, int depth) {
+    MoveList moves;
+    position.generateAllMoves<Us>(moves);
+
+    if (depth == 1)  /* bulk counting: the moves are legal, no need to play them */
+        return moves.size;
+
+    /* the depth is part of the key, so that the same position at different depths does not collide */
+    uint64_t key = position.key ^ (depth * 0x9E3779B97F4A7C15ULL);
+    PerftSlot *slot = table ? &table[key & mask] : nullptr;
+
+    if (slot) {
+        uint64_t nodes = slot->count.load(std::memory_order_relaxed);
+        if ((slot->check.load(std::memory_order_relaxed) ^ nodes) == key)
+            return nodes;
+    }
+
+    uint64_t nodes = 0;
+    UndoRecord undo;
+    for (int i = 0; i < moves.size; i++) {
+        position.makeMove<Us>(moves[i], undo);
+        nodes += count<opponentOf(Us)>(position, depth - 1);
+        position.undoMove<Us>(moves[i], undo);
+    }
+
+    if (slot) {
+        slot->check.store(key ^ nodes, std::memory_order_relaxed);
+        slot->count.store(nodes, std::memory_order_relaxed);
+    }
+
+    return nodes;
+}
+
+uint64_t Perft::run(const Position &position, int depth, bool divide, std::ostream &out) {
+    auto start = std::chrono::steady_clock::now();
+
+    MoveList moves;
+    Position root = position;
+    root.generateAllMoves(moves);
+
+    /* the threads take the root moves one at a time */
+    std::vector<uint64_t> counts(moves.size, 1);
+    std::atomic<int> next(0);
+
+    auto worker = [&]() {
+        for (int i = next++; i < moves.size; i = next++) {
+            if (depth > 1) {
+                Position child = position;
+                child.doMove(moves[i]);
+                counts[i] = (child.sideToMove == WHITE) ? count<WHITE>(child, depth - 1)
+                                                        : count<BLACK>(child, depth - 1);
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int i = 1; i < threads; i++)
+        workers.emplace_back(worker);
+    worker();
+    for (std::thread &t : workers)
+        t.join();
+
+    uint64_t nodes = 0;
+    for (int i = 0; i < moves.size; i++) {
+        nodes += counts[i];
+        if (divide)
+            out << moves[i].toString() << ": " << counts[i] << "\n";
+    }
+
+    int64_t ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+    out << "Nodes: " << nodes << " Time: " << ms << " ms NPS: " << nodes * 1000 / std::max<int64_t>(ms, 1) << "\n";
+    return nodes;
+}
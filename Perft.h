@@ -0,0 +1,49 @@
+#ifndef PERFT_H
+#define PERFT_H
+#include <bits/stdc++.h>
+
+#include "Position.h"
+
+#define PERFT_HASH_MB 16  /* default size of the table of subtree counts */
+
+/* subtree count, XOR-verified like the transposition table so that the threads can share it without locks */
+typedef struct {
+    std::atomic<uint64_t> check;  /* key ^ count */
+    std::atomic<uint64_t> count;
+} PerftSlot;
+
+/*
+  Move generator test: counts the leaf nodes of the legal move tree of a position. Subtrees reached
+  through different move orders (frequent with drops) are counted once, thanks to a hash table,
+  and the root moves are split between several threads.
+ */
+class Perft {
+ private:
+    PerftSlot *table;  /* nullptr without hashing */
+    uint64_t mask;
+
+    int threads;
+
+    template <PlaySide Us>
+    uint64_t count(Position &position, int depth);
+
+ public:
+    /**
+     * @param threads number of threads sharing the root moves
+     * @param hashMegabytes size of the table of subtree counts, 0 to disable it
+     */
+    Perft(int threads = 1, size_t hashMegabytes = PERFT_HASH_MB);
+
+    ~Perft();
+
+    /**
+     * Count the leaf nodes at depth and print the total, the time and the nodes per second.
+     * @param position root position
+     * @param depth depth, at least 1
+     * @param divide whether to also print the count of each root move
+     * @param out stream the results are printed to
+     * @return the number of leaf nodes
+     */
+    uint64_t run(const Position &position, int depth, bool divide, std::ostream &out);
+};
+#endif
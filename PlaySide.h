@@ -3,4 +3,9 @@
 
 enum PlaySide { BLACK = 0, WHITE = 1, NONE = 2 };
 
+/* opponent of a side known at compile time, for the code specialized on the side to move */
+constexpr PlaySide opponentOf(PlaySide playSide) {
+    return (playSide == WHITE) ? BLACK : WHITE;
+}
+
 #endif // !PLAYSIDE_H
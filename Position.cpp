@@ -0,0 +1,1286 @@
+#include "Position.h"
+
+#include <bits/stdc++.h>
+
+#include "Evaluation.h"
+#include "Zobrist.h"
+
+/**
+ * Initialize the chess board representation, with all pieces in the starting position,
+ * and reset pockets, castling rights and counters.
+*/
+Position::Position() {
+    clear();
+
+    static const int backRank[] = {ROOK, KNIGHT, BISHOP, QUEEN, KING, BISHOP, KNIGHT, ROOK};
+
+    for (int file = 1; file <= BOARD_SIZE; file++) {
+        putPiece(makeSquare(1, file), getBoardPiece(Piece(backRank[file - 1]), WHITE));
+        putPiece(makeSquare(2, file), WHITE_PAWN);
+        putPiece(makeSquare(7, file), BLACK_PAWN);
+        putPiece(makeSquare(8, file), getBoardPiece(Piece(backRank[file - 1]), BLACK));
+    }
+
+    for (int i = 0; i < 2; i++)
+        for (int j = 0; j < 2; j++)
+            castlePossible[i][j] = true;
+
+    key = computeKey();
+}
+
+/**
+ * Empty the board and the pockets, with white to move and no castling rights.
+*/
+void Position::clear() {
+    for (int side = 0; side < 2; side++) {
+        for (int piece = 0; piece < 6; piece++)
+            pieces[side][piece] = 0;
+        occupied[side] = 0;
+    }
+
+    occupiedAll = 0;
+    promoted = 0;
+    key = 0;
+    psqScore[WHITE] = psqScore[BLACK] = 0;
+
+    for (int sq = 0; sq < SQUARES; sq++)
+        board[sq] = EMPTY;
+
+    for (int i = 0; i < 2; i++)
+        for (int j = 0; j < 2; j++)
+            castlePossible[i][j] = false;
+
+    for (int i = 0; i < 5; i++)
+        pool[WHITE][i] = pool[BLACK][i] = 0;
+
+    enPassantSquare = NO_SQUARE;
+    moveCount = 0;
+    sideToMove = WHITE;
+}
+
+/**
+ * Set up the position described by a crazyhouse FEN: the usual six fields (the last two optional),
+ * with the pockets after the board, either in brackets or as a ninth rank ("...RNBQKBNR[Qp] w" or
+ * "...RNBQKBNR/Qp w"), and promoted pieces followed by '~'.
+ * @param fen position in FEN
+ * @returns false if fen is not a valid position, which is then left unchanged
+*/
+bool Position::setFEN(const std::string &fen) {
+    static const std::string pieceLetters = "PRBNQK";  /* in Piece order */
+
+    std::stringstream stream(fen);
+    std::string placement, side, castling = "-", enPassant = "-";
+    int halfmoves = 0;
+
+    stream >> placement >> side >> castling >> enPassant >> halfmoves;
+    if (side != "w" && side != "b")
+        return false;
+
+    Position result;
+    result.clear();
+
+    /* board, from a8 to h1 */
+    int rank = 8, file = 1;
+    size_t i = 0;
+
+    for (; i < placement.size() && placement[i] != '['; i++) {
+        char c = placement[i];
+        size_t letter = pieceLetters.find(toupper(c));
+
+        if (c == '/') {
+            if (file != BOARD_SIZE + 1)
+                return false;
+            if (rank == 1)  /* pockets as a ninth rank */
+                break;
+            rank--;
+            file = 1;
+        } else if (c >= '1' && c <= '8') {
+            file += c - '0';
+        } else if (c == '~') {  /* the piece just placed is a promoted pawn */
+            int sq = makeSquare(rank, file - 1);
+            if (file == 1 || result.board[sq] == EMPTY || getPiece(result.board[sq]) == PAWN ||
+                getPiece(result.board[sq]) == KING)
+                return false;
+            result.setPromoted(sq);
+        } else if (letter != std::string::npos && file <= BOARD_SIZE) {
+            result.putPiece(makeSquare(rank, file), getBoardPiece(Piece(letter), isupper(c) ? WHITE : BLACK));
+            file++;
+        } else {
+            return false;
+        }
+
+        if (file > BOARD_SIZE + 1)
+            return false;
+    }
+
+    if (rank != 1 || file != BOARD_SIZE + 1)
+        return false;
+
+    /* pockets: white pieces in upper case, black ones in lower case, '-' for empty pockets */
+    for (i++; i < placement.size() && placement[i] != ']'; i++) {
+        char c = placement[i];
+        size_t letter = pieceLetters.find(toupper(c));
+        PlaySide playSide = isupper(c) ? WHITE : BLACK;
+
+        if (c == '-')
+            continue;
+        if (letter == std::string::npos || letter == KING || result.pool[playSide][letter] == MAX_POCKET)
+            return false;
+
+        result.addToPool(playSide, Piece(letter));
+    }
+
+    if (popCount(result.pieces[WHITE][KING]) != 1 || popCount(result.pieces[BLACK][KING]) != 1)
+        return false;
+
+    if ((result.pieces[WHITE][PAWN] | result.pieces[BLACK][PAWN]) & (RANK_1 | RANK_8))
+        return false;
+
+    /* every piece of a type can end up in a single pocket (promoted ones as pawns), which holds MAX_POCKET */
+    for (int piece = PAWN; piece < KING; piece++) {
+        Bitboard onBoard = (result.pieces[WHITE][piece] | result.pieces[BLACK][piece]) & ~result.promoted;
+        int count = popCount(onBoard) + result.pool[WHITE][piece] + result.pool[BLACK][piece];
+
+        if (piece == PAWN)
+            count += popCount(result.promoted);
+        if (count > MAX_POCKET)
+            return false;
+    }
+
+    result.sideToMove = (side == "w") ? WHITE : BLACK;
+
+    /* the side that just moved cannot have left its king in check */
+    PlaySide opponent = getOpponentPlaySide(result.sideToMove);
+    if (result.attackersTo(result.getKingSquare(opponent), result.sideToMove, result.occupiedAll))
+        return false;
+
+    /* castling rights, kept only with the king and the rook on their squares */
+    for (char c : castling) {
+        PlaySide playSide = isupper(c) ? WHITE : BLACK;
+        int type = (toupper(c) == 'Q') ? 0 : 1;
+        int backRank = (playSide == WHITE) ? 1 : BOARD_SIZE;
+
+        if ((toupper(c) == 'K' || toupper(c) == 'Q') &&
+            result.board[makeSquare(backRank, 5)] == getBoardPiece(KING, playSide) &&
+            result.board[makeSquare(backRank, type ? BOARD_SIZE : 1)] == getBoardPiece(ROOK, playSide))
+            result.castlePossible[playSide][type] = true;
+    }
+
+    /* en passant square, behind a pawn of the side that just moved */
+    if (enPassant != "-") {
+        if (enPassant.size() != 2 || enPassant[0] < 'a' || enPassant[0] > 'h' ||
+            enPassant[1] != (result.sideToMove == WHITE ? '6' : '3'))
+            return false;
+        result.enPassantSquare = stringToSquare(enPassant);
+    }
+
+    result.moveCount = std::max(halfmoves, 0);
+    result.key = result.computeKey();
+
+    *this = result;
+    return true;
+}
+
+/**
+ * Compute the Zobrist key of the position from scratch. The key is otherwise updated incrementally.
+ * @returns the key
+*/
+uint64_t Position::computeKey() {
+    uint64_t result = 0;
+
+    for (int sq = 0; sq < SQUARES; sq++) {
+        result ^= pieceKeys[board[sq]][sq];
+        if (promoted & squareBB(sq))
+            result ^= promotedKeys[sq];
+    }
+
+    for (int side = 0; side < 2; side++) {
+        for (int piece = 0; piece < 5; piece++)
+            result ^= pocketKeys[side][piece][pool[side][piece]];
+
+        for (int type = 0; type < 2; type++)
+            if (castlePossible[side][type])
+                result ^= castleKeys[side][type];
+    }
+
+    if (enPassantSquare != NO_SQUARE)
+        result ^= enPassantKeys[fileOf(enPassantSquare) - 1];
+
+    if (sideToMove == WHITE)
+        result ^= sideKey;
+
+    return result;
+}
+
+/**
+ * Get play side of the opponent.
+ * @param playSide side to move
+ * @returns opponent's play side
+*/
+PlaySide Position::getOpponentPlaySide(PlaySide playSide) {
+    switch (playSide) {
+        case BLACK: return WHITE;
+        case WHITE: return BLACK;
+        default: return NONE;
+    }
+}
+
+/**
+ *  Get BoardPiece value.
+ * @param piece piece
+ * @param playSide side to move
+ * @returns BoardPiece value of piece of color playSide
+*/
+int Position::getBoardPiece(Piece piece, PlaySide playSide) {
+    return piece + (playSide == BLACK) * 6 + 1;
+}
+
+/**
+ * Returns the side of the piece with given value.
+ * @param value value of piece on the board
+*/
+PlaySide Position::getPlaySide(int value) {
+    if (value == 0)
+        return PlaySide::NONE;
+
+    if (value <= 6)
+        return PlaySide::WHITE;
+
+    return PlaySide::BLACK;
+}
+
+/**
+ * Returns a Piece with given value.
+ * @param value value of piece on the board
+*/
+Piece Position::getPiece(int value) {
+    return Piece((value - 1) % 6);
+}
+
+/**
+ * Place a piece on an empty square.
+ * @param sq square
+ * @param value BoardPiece value of the piece
+*/
+void Position::putPiece(int sq, int value) {
+    Bitboard b = squareBB(sq);
+    PlaySide playSide = getPlaySide(value);
+
+    pieces[playSide][getPiece(value)] |= b;
+    occupied[playSide] |= b;
+    occupiedAll |= b;
+    board[sq] = value;
+    key ^= pieceKeys[value][sq];
+    psqScore[playSide] += pieceSquareScore[value][sq];
+}
+
+/**
+ * Remove the piece (and its promoted flag) from a square.
+ * @param sq square, must not be empty
+*/
+void Position::removePiece(int sq) {
+    Bitboard b = squareBB(sq);
+    int value = board[sq];
+    PlaySide playSide = getPlaySide(value);
+
+    pieces[playSide][getPiece(value)] &= ~b;
+    occupied[playSide] &= ~b;
+    occupiedAll &= ~b;
+    board[sq] = EMPTY;
+    key ^= pieceKeys[value][sq];
+    psqScore[playSide] -= pieceSquareScore[value][sq];
+
+    if (promoted & b) {
+        promoted &= ~b;
+        key ^= promotedKeys[sq];
+    }
+}
+
+/**
+ * Flag the piece on sq as a promoted pawn.
+*/
+void Position::setPromoted(int sq) {
+    promoted |= squareBB(sq);
+    key ^= promotedKeys[sq];
+}
+
+/**
+ * Add a piece to the pocket of playSide.
+*/
+void Position::addToPool(PlaySide playSide, Piece piece) {
+    int &count = pool[playSide][piece];
+    key ^= pocketKeys[playSide][piece][count] ^ pocketKeys[playSide][piece][count + 1];
+    psqScore[playSide] += pocketScore[piece];
+    count++;
+}
+
+/**
+ * Take a piece out of the pocket of playSide.
+*/
+void Position::takeFromPool(PlaySide playSide, Piece piece) {
+    int &count = pool[playSide][piece];
+    key ^= pocketKeys[playSide][piece][count] ^ pocketKeys[playSide][piece][count - 1];
+    psqScore[playSide] -= pocketScore[piece];
+    count--;
+}
+
+/**
+ * Pass the turn to the other side.
+*/
+void Position::switchSideToMove() {
+    sideToMove = getOpponentPlaySide(sideToMove);
+    key ^= sideKey;
+}
+
+/**
+ * Remove a castling right, if it was still available.
+ * @param type type 0 -> Queen side castle, type 1 -> King side castle
+*/
+void Position::clearCastleRight(PlaySide playSide, int type) {
+    if (castlePossible[playSide][type]) {
+        castlePossible[playSide][type] = false;
+        key ^= castleKeys[playSide][type];
+    }
+}
+
+/**
+ * Set the en passant square, NO_SQUARE if there is none.
+*/
+void Position::setEnPassantSquare(int sq) {
+    if (enPassantSquare != NO_SQUARE)
+        key ^= enPassantKeys[fileOf(enPassantSquare) - 1];
+
+    enPassantSquare = sq;
+
+    if (enPassantSquare != NO_SQUARE)
+        key ^= enPassantKeys[fileOf(enPassantSquare) - 1];
+}
+
+/**
+ * Move the piece at src, together with its promoted flag, to the empty square dst.
+ * @param src source square
+ * @param dst destination square
+*/
+void Position::relocatePiece(int src, int dst) {
+    int value = board[src];
+    bool isPromoted = promoted & squareBB(src);
+
+    removePiece(src);
+    putPiece(dst, value);
+
+    if (isPromoted)
+        setPromoted(dst);
+}
+
+/**
+ * Play a move of the game.
+ * @param move move
+*/
+void Position::doMove(PackedMove move) {
+    UndoRecord undo;
+    makeMove(move, undo);
+}
+
+/**
+ * Pack a move received from xboard, flagging castles and en passant captures.
+ * @param move received move
+ * @returns the packed move
+*/
+PackedMove Position::parseMove(Move* move) {
+    PackedMove packed = PackedMove::fromMove(move);
+    if (!packed.isNormal())
+        return packed;
+
+    int src = packed.getSource(), dst = packed.getDestination();
+    Piece pieceToMove = getPiece(board[src]);
+
+    if (pieceToMove == KING && abs(fileOf(src) - fileOf(dst)) > 1)
+        return PackedMove::moveTo(src, dst, CASTLE);
+
+    if (pieceToMove == PAWN && fileOf(src) != fileOf(dst) && board[dst] == EMPTY)
+        return PackedMove::moveTo(src, dst, EN_PASSANT);
+
+    return packed;
+}
+
+/**
+ * Find the King's square on the board.
+ * @param playSide side to move
+ * @returns the square of playSide's King
+*/
+int Position::getKingSquare(PlaySide playSide) {
+    return lsb(pieces[playSide][KING]);
+}
+
+/**
+ * Check if square sq is attacked by any piece of the attacker side.
+ * @param sq square
+ * @param attacker side of the attacking pieces
+ * @param occupancy occupied squares, used to block sliding pieces
+ * @return true if sq is attacked, false otherwise
+*/
+bool Position::isSquareAttacked(int sq, PlaySide attacker, Bitboard occupancy) {
+    const Bitboard *attackerPieces = pieces[attacker];
+
+    if (pawnAttacks[opponentOf(attacker)][sq] & attackerPieces[PAWN])
+        return true;
+
+    if (knightAttacks[sq] & attackerPieces[KNIGHT])
+        return true;
+
+    if (kingAttacks[sq] & attackerPieces[KING])
+        return true;
+
+    if (bishopAttacks(sq, occupancy) & (attackerPieces[BISHOP] | attackerPieces[QUEEN]))
+        return true;
+
+    return rookAttacks(sq, occupancy) & (attackerPieces[ROOK] | attackerPieces[QUEEN]);
+}
+
+/**
+ * Get all the pieces of attacker that attack square sq.
+ * @param sq square
+ * @param attacker side of the attacking pieces
+ * @param occupancy occupied squares, used to block sliding pieces
+ * @return bitboard of the attacking pieces
+*/
+Bitboard Position::attackersTo(int sq, PlaySide attacker, Bitboard occupancy) {
+    const Bitboard *attackerPieces = pieces[attacker];
+
+    return (pawnAttacks[opponentOf(attacker)][sq] & attackerPieces[PAWN])
+         | (knightAttacks[sq] & attackerPieces[KNIGHT])
+         | (kingAttacks[sq] & attackerPieces[KING])
+         | (bishopAttacks(sq, occupancy) & (attackerPieces[BISHOP] | attackerPieces[QUEEN]))
+         | (rookAttacks(sq, occupancy) & (attackerPieces[ROOK] | attackerPieces[QUEEN]));
+}
+
+/**
+ * Get the opponent's pieces giving check to the King of playSide.
+ * @param playSide side to move
+*/
+Bitboard Position::getCheckers(PlaySide playSide) {
+    return attackersTo(getKingSquare(playSide), opponentOf(playSide), occupiedAll);
+}
+
+/**
+ * Get the pieces of playSide that are pinned to their King, i.e. the only piece
+ * between the King and an opponent's sliding piece.
+ * @param playSide side to move
+*/
+Bitboard Position::getPinned(PlaySide playSide) {
+    PlaySide opponentPlaySide = opponentOf(playSide);
+    const Bitboard *opponentPieces = pieces[opponentPlaySide];
+    int kingSquare = getKingSquare(playSide);
+    Bitboard pinned = 0;
+
+    /* opponent's sliders that would attack the King on an empty board */
+    Bitboard snipers = (rookAttacks(kingSquare, 0) & (opponentPieces[ROOK] | opponentPieces[QUEEN]))
+                     | (bishopAttacks(kingSquare, 0) & (opponentPieces[BISHOP] | opponentPieces[QUEEN]));
+
+    while (snipers) {
+        Bitboard blockers = betweenBB[kingSquare][popLsb(snipers)] & occupiedAll;
+        if (popCount(blockers) == 1 && (blockers & occupied[playSide]))
+            pinned |= blockers;
+    }
+
+    return pinned;
+}
+
+/**
+ * Check if the King of playSide is in check.
+ * @param playSide side to move
+ * @return true if playSide's King is in check, false otherwise
+*/
+bool Position::inCheck(PlaySide playSide) {
+    return isSquareAttacked(getKingSquare(playSide), opponentOf(playSide), occupiedAll);
+}
+
+/**
+ * Check if the given move lands into check.
+ * @param move move
+ * @param playSide side to move
+ * @return true if move lands into check, false otherwise
+*/
+bool Position::landsInCheck(PackedMove move, PlaySide playSide) {
+    /* make the move, check if it lands in check, then undo the move */
+    UndoRecord undo;
+    makeMove(move, undo);
+
+    bool result = inCheck(playSide);
+
+    undoMove(move, undo);
+
+    return result;
+}
+
+/**
+ * Check whether move captures a piece, en passant included.
+ * @param move move of the side to move
+ * @returns true if a piece is captured, false otherwise
+*/
+bool Position::isCapture(PackedMove move) {
+    return !move.isDropIn() && (board[move.getDestination()] != EMPTY || move.isEnPassant());
+}
+
+/**
+ * Rules for castling:
+ * - your king and rook can NOT have moved, once your king or rook moves, you can no longer castle
+ * - your king can NOT be in check
+ * - your king can NOT pass through check - if any square the king moves over or moves onto
+ *   would put you in check, you can't castle
+ * - no pieces can be between the king and rook
+ * @tparam Us side to move
+ * @param type type 0 -> Queen side castle, type 1 -> King side castle
+ * @returns true if castling of given type is possible, false otherwise
+*/
+template <PlaySide Us>
+bool Position::spaceForCastle(int type) {
+    constexpr int row = (Us == WHITE) ? 1 : 8;
+    int start, end;
+
+    if (type == 0) {
+        start = 2;
+        end = 4;
+    } else {
+        start = 6;
+        end = 7;
+    }
+
+    if (board[makeSquare(row, 5)] != getBoardPiece(KING, Us) ||
+        board[makeSquare(row, type == 0 ? 1 : 8)] != getBoardPiece(ROOK, Us))
+        return false;
+
+    for (int i = start; i <= end; i++) {
+        if (board[makeSquare(row, i)] != BoardPiece::EMPTY)
+            return false;
+
+        /* the rook, but not the king, may pass over the attacked b-file square */
+        if (i > 2 && isSquareAttacked(makeSquare(row, i), opponentOf(Us), occupiedAll))
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * Add the castle moves of the side to move, which must not be in check.
+ * @tparam Us side to move
+ * @param kingSquare square of the king of the side to move
+ * @param moves list the castle moves are appended to
+*/
+template <PlaySide Us>
+void Position::pushCastles(int kingSquare, MoveList &moves) {
+    if (castlePossible[Us][1] && spaceForCastle<Us>(1))
+        moves.push(PackedMove::moveTo(kingSquare, kingSquare + 2, CASTLE));
+
+    if (castlePossible[Us][0] && spaceForCastle<Us>(0))
+        moves.push(PackedMove::moveTo(kingSquare, kingSquare - 2, CASTLE));
+}
+
+/**
+ * Push the moves of the piece at src to every square in targets.
+ * @param src source square
+ * @param targets destination squares, already restricted to legal ones
+ * @param moves list of moves
+*/
+void Position::pushPieceMoves(int src, Bitboard targets, MoveList &moves) {
+    while (targets)
+        moves.push(PackedMove::moveTo(src, popLsb(targets)));
+}
+
+/**
+ * Add the promotions of a pawn moving from src to dst, to every piece from QUEEN down to KNIGHT.
+*/
+void Position::pushPromotions(int src, int dst, MoveList &moves) {
+    moves.push(PackedMove::promote(src, dst, QUEEN));
+    moves.push(PackedMove::promote(src, dst, ROOK));
+    moves.push(PackedMove::promote(src, dst, BISHOP));
+    moves.push(PackedMove::promote(src, dst, KNIGHT));
+}
+
+/**
+ * Add the underpromotions of a pawn moving from src to dst, to ROOK, BISHOP and KNIGHT. The queen
+ * promotions are generated with the captures.
+*/
+void Position::pushUnderpromotions(int src, int dst, MoveList &moves) {
+    moves.push(PackedMove::promote(src, dst, ROOK));
+    moves.push(PackedMove::promote(src, dst, BISHOP));
+    moves.push(PackedMove::promote(src, dst, KNIGHT));
+}
+
+/**
+ * Generate all legal moves of the side to move. Checkers and pinned pieces are computed once, so that
+ * only king moves and en passant captures need a full legality check.
+ * @param moves list filled with all possible moves of the side to move, given the current board configuration
+*/
+void Position::generateAllMoves(MoveList &moves) {
+    if (sideToMove == WHITE)
+        generateAllMoves<WHITE>(moves);
+    else
+        generateAllMoves<BLACK>(moves);
+}
+
+/**
+ * Generate all legal moves of Us, the side to move, with the same generators the search uses one
+ * group at a time: the evasions when in check, otherwise the captures, the quiet moves and the drops.
+ * Perft counts therefore check the staged generators.
+*/
+template <PlaySide Us>
+void Position::generateAllMoves(MoveList &moves) {
+    Bitboard checkers = getCheckers(Us);
+
+    if (checkers) {
+        generateEvasions<Us>(moves);
+        return;
+    }
+
+    Bitboard pinned = getPinned(Us);
+
+    moves.clear();
+    pushCaptures<Us>(checkers, pinned, moves);
+    pushQuiets<Us>(checkers, pinned, moves);
+    pushDrops<Us>(checkers, moves);
+}
+
+/**
+ * Generate the legal captures and queen promotions of the side to move, without the quiet moves
+ * and drops of generateAllMoves.
+ * @param moves list filled with the moves
+*/
+void Position::generateCaptures(MoveList &moves) {
+    if (sideToMove == WHITE)
+        generateCaptures<WHITE>(moves);
+    else
+        generateCaptures<BLACK>(moves);
+}
+
+template <PlaySide Us>
+void Position::generateCaptures(MoveList &moves) {
+    moves.clear();
+    pushCaptures<Us>(getCheckers(Us), getPinned(Us), moves);
+}
+
+/**
+ * Add the captures and queen promotions of Us, the side to move.
+ * @param checkers pieces giving check to the king of Us
+ * @param pinned pieces of Us pinned to their king
+ * @param moves list the moves are appended to
+*/
+template <PlaySide Us>
+void Position::pushCaptures(Bitboard checkers, Bitboard pinned, MoveList &moves) {
+    constexpr PlaySide Them = opponentOf(Us);
+    int kingSquare = getKingSquare(Us);
+
+    Bitboard kingTargets = kingAttacks[kingSquare] & occupied[Them];
+    while (kingTargets) {
+        int dst = popLsb(kingTargets);
+        if (!isSquareAttacked(dst, Them, occupiedAll ^ squareBB(kingSquare)))
+            moves.push(PackedMove::moveTo(kingSquare, dst));
+    }
+
+    if (popCount(checkers) > 1)
+        return;
+
+    /* with a single checker, the only capture that does not leave the king in check is the checker's */
+    Bitboard targets = checkers ? checkers : occupied[Them];
+    Bitboard pushTargets = checkers ? betweenBB[kingSquare][lsb(checkers)] : ~occupiedAll;
+
+    constexpr int dir = pawnPush(Us);
+    constexpr Bitboard promotionRankBB = promotionRank(Us);
+
+    Bitboard pawns = pieces[Us][PAWN];
+    while (pawns) {
+        int sq = popLsb(pawns);
+        Bitboard line = (pinned & squareBB(sq)) ? lineBB[kingSquare][sq] : ~0ULL;
+
+        Bitboard captures = pawnAttacks[Us][sq] & targets & line;
+        while (captures) {
+            int dst = popLsb(captures);
+
+            if (squareBB(dst) & promotionRankBB)
+                moves.push(PackedMove::promote(sq, dst, QUEEN));
+            else
+                moves.push(PackedMove::moveTo(sq, dst));
+        }
+
+        if (enPassantSquare != NO_SQUARE && (pawnAttacks[Us][sq] & squareBB(enPassantSquare)) &&
+            enPassantRights(sq, enPassantSquare))
+            moves.push(PackedMove::moveTo(sq, enPassantSquare, EN_PASSANT));
+
+        if ((squareBB(sq + dir) & promotionRankBB & pushTargets & line))
+            moves.push(PackedMove::promote(sq, sq + dir, QUEEN));
+    }
+
+    Bitboard knights = pieces[Us][KNIGHT] & ~pinned;
+    while (knights) {
+        int sq = popLsb(knights);
+        pushPieceMoves(sq, knightAttacks[sq] & targets, moves);
+    }
+
+    Bitboard sliders = pieces[Us][ROOK] | pieces[Us][BISHOP] | pieces[Us][QUEEN];
+    while (sliders) {
+        int sq = popLsb(sliders);
+        Bitboard allowed = (pinned & squareBB(sq)) ? targets & lineBB[kingSquare][sq] : targets;
+        Piece piece = getPiece(board[sq]);
+        Bitboard attacks = (piece == ROOK) ? rookAttacks(sq, occupiedAll) :
+                           (piece == BISHOP) ? bishopAttacks(sq, occupiedAll) : queenAttacks(sq, occupiedAll);
+        pushPieceMoves(sq, attacks & allowed, moves);
+    }
+}
+
+/**
+ * Generate the legal moves of the side to move that generateCaptures leaves out, drops excepted:
+ * moves to empty squares, castles and underpromotions.
+ * @param moves list the moves are appended to
+*/
+void Position::generateQuiets(MoveList &moves) {
+    if (sideToMove == WHITE)
+        generateQuiets<WHITE>(moves);
+    else
+        generateQuiets<BLACK>(moves);
+}
+
+template <PlaySide Us>
+void Position::generateQuiets(MoveList &moves) {
+    pushQuiets<Us>(getCheckers(Us), getPinned(Us), moves);
+}
+
+/**
+ * Add the moves of Us, the side to move, to empty squares, its castles and underpromotions.
+ * @param checkers pieces giving check to the king of Us
+ * @param pinned pieces of Us pinned to their king
+ * @param moves list the moves are appended to
+*/
+template <PlaySide Us>
+void Position::pushQuiets(Bitboard checkers, Bitboard pinned, MoveList &moves) {
+    constexpr PlaySide Them = opponentOf(Us);
+    int kingSquare = getKingSquare(Us);
+
+    /* king moves, checked against the opponent's attacks with the king removed from the board */
+    Bitboard kingTargets = kingAttacks[kingSquare] & ~occupiedAll;
+    while (kingTargets) {
+        int dst = popLsb(kingTargets);
+        if (!isSquareAttacked(dst, Them, occupiedAll ^ squareBB(kingSquare)))
+            moves.push(PackedMove::moveTo(kingSquare, dst));
+    }
+
+    if (!checkers)
+        pushCastles<Us>(kingSquare, moves);
+
+    /* double check, only the king can move */
+    if (popCount(checkers) > 1)
+        return;
+
+    /* empty squares other pieces may move to, and the pieces a pawn may capture when underpromoting */
+    Bitboard targets = checkers ? betweenBB[kingSquare][lsb(checkers)] : ~occupiedAll;
+    Bitboard captureTargets = checkers ? checkers : occupied[Them];
+
+    constexpr int dir = pawnPush(Us);
+    constexpr Bitboard promotionRankBB = promotionRank(Us);
+    constexpr Bitboard doublePushRankBB = doublePushRank(Us);
+
+    Bitboard pawns = pieces[Us][PAWN];
+    while (pawns) {
+        int sq = popLsb(pawns);
+
+        /* a pinned piece can only move along the line between its king and the pinner */
+        Bitboard line = (pinned & squareBB(sq)) ? lineBB[kingSquare][sq] : ~0ULL;
+
+        Bitboard promotions = ((pawnAttacks[Us][sq] & captureTargets) | (squareBB(sq + dir) & targets)) &
+                              promotionRankBB & line;
+        while (promotions)
+            pushUnderpromotions(sq, popLsb(promotions), moves);
+
+        if (board[sq + dir] == EMPTY && !(squareBB(sq + dir) & promotionRankBB)) {
+            if (targets & line & squareBB(sq + dir))
+                moves.push(PackedMove::moveTo(sq, sq + dir));
+
+            if ((squareBB(sq) & doublePushRankBB) && board[sq + 2 * dir] == EMPTY &&
+                (targets & line & squareBB(sq + 2 * dir)))
+                moves.push(PackedMove::moveTo(sq, sq + 2 * dir));
+        }
+    }
+
+    /* a pinned knight can never move */
+    Bitboard knights = pieces[Us][KNIGHT] & ~pinned;
+    while (knights) {
+        int sq = popLsb(knights);
+        pushPieceMoves(sq, knightAttacks[sq] & targets, moves);
+    }
+
+    Bitboard sliders = pieces[Us][ROOK] | pieces[Us][BISHOP] | pieces[Us][QUEEN];
+    while (sliders) {
+        int sq = popLsb(sliders);
+        Bitboard allowed = (pinned & squareBB(sq)) ? targets & lineBB[kingSquare][sq] : targets;
+        Piece piece = getPiece(board[sq]);
+        Bitboard attacks = (piece == ROOK) ? rookAttacks(sq, occupiedAll) :
+                           (piece == BISHOP) ? bishopAttacks(sq, occupiedAll) : queenAttacks(sq, occupiedAll);
+        pushPieceMoves(sq, attacks & allowed, moves);
+    }
+}
+
+/**
+ * Generate the legal drops of the side to move: anywhere on an empty square, or between the king
+ * and a single checker. A dropped piece never exposes its own king.
+ * @param moves list the drops are appended to
+*/
+void Position::generateDrops(MoveList &moves) {
+    if (sideToMove == WHITE)
+        generateDrops<WHITE>(moves);
+    else
+        generateDrops<BLACK>(moves);
+}
+
+template <PlaySide Us>
+void Position::generateDrops(MoveList &moves) {
+    pushDrops<Us>(getCheckers(Us), moves);
+}
+
+/**
+ * Add the drops of Us, the side to move.
+ * @param checkers pieces giving check to the king of Us
+ * @param moves list the drops are appended to
+*/
+template <PlaySide Us>
+void Position::pushDrops(Bitboard checkers, MoveList &moves) {
+    /* double check, only the king can move */
+    if (popCount(checkers) > 1)
+        return;
+
+    Bitboard targets = checkers ? betweenBB[getKingSquare(Us)][lsb(checkers)] : ~occupiedAll;
+
+    for (int i = 0; i < 5; i++) {
+        if (pool[Us][i] > 0) {
+            Bitboard squares = targets;
+            if (i == 0)  /* Pawns cannot be placed on rows 1 and 8 */
+                squares &= ~(RANK_1 | RANK_8);
+
+            while (squares)
+                moves.push(PackedMove::dropIn(popLsb(squares), Piece(i)));
+        }
+    }
+}
+
+/**
+ * Generate the legal moves of the side to move, which must be in check: king moves to squares out of
+ * check and, against a single checker, its captures and the moves and drops interposing between it and
+ * the king. A pinned piece can never do either, so only the unpinned pieces are looked at.
+ * @param moves list filled with the moves
+*/
+void Position::generateEvasions(MoveList &moves) {
+    if (sideToMove == WHITE)
+        generateEvasions<WHITE>(moves);
+    else
+        generateEvasions<BLACK>(moves);
+}
+
+template <PlaySide Us>
+void Position::generateEvasions(MoveList &moves) {
+    constexpr PlaySide Them = opponentOf(Us);
+    moves.clear();
+
+    int kingSquare = getKingSquare(Us);
+    Bitboard checkers = getCheckers(Us);
+
+    /* king moves, checked against the opponent's attacks with the king removed from the board */
+    Bitboard kingTargets = kingAttacks[kingSquare] & ~occupied[Us];
+    while (kingTargets) {
+        int dst = popLsb(kingTargets);
+        if (!isSquareAttacked(dst, Them, occupiedAll ^ squareBB(kingSquare)))
+            moves.push(PackedMove::moveTo(kingSquare, dst));
+    }
+
+    /* double check, only the king can move */
+    if (popCount(checkers) > 1)
+        return;
+
+    Bitboard blocks = betweenBB[kingSquare][lsb(checkers)];
+    Bitboard targets = checkers | blocks;
+    Bitboard movable = occupied[Us] & ~getPinned(Us);
+
+    constexpr int dir = pawnPush(Us);
+    constexpr Bitboard promotionRankBB = promotionRank(Us);
+    constexpr Bitboard doublePushRankBB = doublePushRank(Us);
+
+    Bitboard pawns = pieces[Us][PAWN] & movable;
+    while (pawns) {
+        int sq = popLsb(pawns);
+
+        Bitboard destinations = (pawnAttacks[Us][sq] & checkers) | (squareBB(sq + dir) & blocks);
+        if ((squareBB(sq) & doublePushRankBB) && board[sq + dir] == EMPTY)
+            destinations |= squareBB(sq + 2 * dir) & blocks;
+
+        while (destinations) {
+            int dst = popLsb(destinations);
+
+            if (squareBB(dst) & promotionRankBB)
+                pushPromotions(sq, dst, moves);
+            else
+                moves.push(PackedMove::moveTo(sq, dst));
+        }
+
+        /* the checker may be the pawn that has just advanced two squares */
+        if (enPassantSquare != NO_SQUARE && (pawnAttacks[Us][sq] & squareBB(enPassantSquare)) &&
+            enPassantRights(sq, enPassantSquare))
+            moves.push(PackedMove::moveTo(sq, enPassantSquare, EN_PASSANT));
+    }
+
+    Bitboard knights = pieces[Us][KNIGHT] & movable;
+    while (knights) {
+        int sq = popLsb(knights);
+        pushPieceMoves(sq, knightAttacks[sq] & targets, moves);
+    }
+
+    Bitboard sliders = (pieces[Us][ROOK] | pieces[Us][BISHOP] | pieces[Us][QUEEN]) & movable;
+    while (sliders) {
+        int sq = popLsb(sliders);
+        Piece piece = getPiece(board[sq]);
+        Bitboard attacks = (piece == ROOK) ? rookAttacks(sq, occupiedAll) :
+                           (piece == BISHOP) ? bishopAttacks(sq, occupiedAll) : queenAttacks(sq, occupiedAll);
+        pushPieceMoves(sq, attacks & targets, moves);
+    }
+
+    pushDrops<Us>(checkers, moves);
+}
+
+/**
+ * Add up to limit drops that give check to the opponent's king, strongest pieces first.
+ * The side to move must not be in check.
+ * @param moves list the drops are appended to
+ * @param limit maximum number of drops added
+*/
+void Position::generateCheckingDrops(MoveList &moves, int limit) {
+    if (sideToMove == WHITE)
+        generateCheckingDrops<WHITE>(moves, limit);
+    else
+        generateCheckingDrops<BLACK>(moves, limit);
+}
+
+template <PlaySide Us>
+void Position::generateCheckingDrops(MoveList &moves, int limit) {
+    constexpr PlaySide Them = opponentOf(Us);
+    int kingSquare = getKingSquare(Them);
+    Bitboard empty = ~occupiedAll;
+
+    /* squares from which each piece type attacks the king */
+    Bitboard checks[5];
+    checks[PAWN] = pawnAttacks[Them][kingSquare] & ~(RANK_1 | RANK_8);
+    checks[ROOK] = rookAttacks(kingSquare, occupiedAll);
+    checks[BISHOP] = bishopAttacks(kingSquare, occupiedAll);
+    checks[KNIGHT] = knightAttacks[kingSquare];
+    checks[QUEEN] = checks[ROOK] | checks[BISHOP];
+
+    static const Piece order[] = {QUEEN, ROOK, BISHOP, KNIGHT, PAWN};
+
+    for (Piece piece : order) {
+        if (pool[Us][piece] == 0)
+            continue;
+
+        Bitboard squares = checks[piece] & empty;
+        while (squares && limit > 0) {
+            moves.push(PackedMove::dropIn(popLsb(squares), piece));
+            limit--;
+        }
+    }
+}
+
+/**
+ * Check whether a move, e.g. from the transposition table or a killer slot, is legal in this position,
+ * without generating the moves of the side to move.
+ * @param move any move, possibly of another position
+ * @returns true if the move is one generateAllMoves would generate
+*/
+bool Position::isLegal(PackedMove move) {
+    return (sideToMove == WHITE) ? isLegal<WHITE>(move) : isLegal<BLACK>(move);
+}
+
+template <PlaySide Us>
+bool Position::isLegal(PackedMove move) {
+    constexpr PlaySide Them = opponentOf(Us);
+    int dst = move.getDestination();
+    int kingSquare = getKingSquare(Us);
+
+    if (move.isDropIn()) {
+        int piece = move.getSource();
+
+        if (piece >= KING || pool[Us][piece] == 0 || board[dst] != EMPTY ||
+            (piece == PAWN && (squareBB(dst) & (RANK_1 | RANK_8))))
+            return false;
+
+        /* a drop never exposes its own king, in check it must block the single checker */
+        Bitboard checkers = getCheckers(Us);
+        return !checkers || (popCount(checkers) == 1 && (betweenBB[kingSquare][lsb(checkers)] & squareBB(dst)));
+    } else {
+        int src = move.getSource();
+
+        if (board[src] == EMPTY || getPlaySide(board[src]) != Us || (occupied[Us] & squareBB(dst)))
+            return false;
+
+        Piece piece = getPiece(board[src]);
+        Bitboard checkers = getCheckers(Us);
+
+        if (move.isCastle()) {
+            /* the king may not castle out of check, spaceForCastle checks the squares it crosses */
+            int type = (dst == src + 2) ? 1 : 0;
+            return piece == KING && (dst == src + 2 || dst == src - 2) && castlePossible[Us][type] &&
+                   spaceForCastle<Us>(type) && !checkers;
+        }
+
+        if (piece == PAWN) {
+            constexpr int dir = pawnPush(Us);
+
+            if (move.isEnPassant())
+                return dst == enPassantSquare && (pawnAttacks[Us][src] & squareBB(dst)) && enPassantRights(src, dst);
+
+            if (move.getType() > PROMOTION + QUEEN - ROOK || move.isPromotion() != bool(squareBB(dst) & promotionRank(Us)))
+                return false;
+
+            bool reachable = (pawnAttacks[Us][src] & occupied[Them] & squareBB(dst)) ||
+                             (dst == src + dir && board[dst] == EMPTY) ||
+                             (dst == src + 2 * dir && (squareBB(src) & doublePushRank(Us)) &&
+                              board[src + dir] == EMPTY && board[dst] == EMPTY);
+            if (!reachable)
+                return false;
+        } else {
+            if (move.getType() != NORMAL_MOVE)
+                return false;
+
+            Bitboard attacks = (piece == KNIGHT) ? knightAttacks[src] :
+                               (piece == KING) ? kingAttacks[src] :
+                               (piece == ROOK) ? rookAttacks(src, occupiedAll) :
+                               (piece == BISHOP) ? bishopAttacks(src, occupiedAll) : queenAttacks(src, occupiedAll);
+            if (!(attacks & squareBB(dst)))
+                return false;
+
+            /* the king is checked against the opponent's attacks with itself removed from the board */
+            if (piece == KING)
+                return !isSquareAttacked(dst, Them, occupiedAll ^ squareBB(src));
+        }
+
+        /* double check, only the king can move */
+        if (popCount(checkers) > 1)
+            return false;
+
+        /* a pinned piece can only move along the line between its king and the pinner */
+        if ((getPinned(Us) & squareBB(src)) && !(lineBB[kingSquare][src] & squareBB(dst)))
+            return false;
+
+        /* in check, the move must capture or block the single checker */
+        return !checkers || ((checkers | betweenBB[kingSquare][lsb(checkers)]) & squareBB(dst));
+    }
+}
+
+/**
+ * Check if en Passant is possible.
+ * @param src source square
+ * @param dst destination square
+ * @returns true if en Passant is possible, false otherwise
+*/
+bool Position::enPassantRights(int src, int dst) {
+    PlaySide playSide = getPlaySide(board[src]);
+    int capturedSquare = makeSquare(rankOf(src), fileOf(dst));
+
+    /* en passant removes two pieces from the same rank, too rare to handle with pin masks */
+    if (dst == enPassantSquare && (pieces[getOpponentPlaySide(playSide)][PAWN] & squareBB(capturedSquare)) &&
+        !landsInCheck(PackedMove::moveTo(src, dst, EN_PASSANT), playSide))
+        return true;
+
+    return false;
+}
+
+/**
+ * Perform move of the side to move and record changes on board, pockets, castling rights,
+ * en passant square and the number of moves without captures or pawn moves.
+ * @param move move
+ * @param undo filled with what undoMove needs to restore the position
+*/
+void Position::makeMove(PackedMove move, UndoRecord &undo) {
+    if (sideToMove == WHITE)
+        makeMove<WHITE>(move, undo);
+    else
+        makeMove<BLACK>(move, undo);
+}
+
+template <PlaySide Us>
+void Position::makeMove(PackedMove move, UndoRecord &undo) {
+    int dst = move.getDestination();
+
+    undo.key = key;
+    undo.psqScore[WHITE] = psqScore[WHITE];
+    undo.psqScore[BLACK] = psqScore[BLACK];
+    undo.captured = EMPTY;
+    undo.enPassantSquare = enPassantSquare;
+    undo.moveCount = moveCount;
+    memcpy(undo.castlePossible, castlePossible, sizeof(castlePossible));
+
+    setEnPassantSquare(NO_SQUARE);
+
+    if (move.isDropIn()) {
+        Piece piece = move.getReplacement();
+        moveCount = (piece == PAWN) ? 0 : moveCount + 1;
+
+        putPiece(dst, getBoardPiece(piece, Us));
+        takeFromPool(Us, piece);
+        switchSideToMove();
+        return;
+    }
+
+    int src = move.getSource();
+    Piece pieceToMove = getPiece(board[src]);
+
+    /* pawn move or capture, en passant being both */
+    moveCount = (pieceToMove == PAWN || board[dst] != EMPTY) ? 0 : moveCount + 1;
+
+    if (board[dst] != EMPTY) {/* capture piece */
+        undo.captured = board[dst];
+        if (promoted & squareBB(dst)) {  /* promoted piece turns into PAWN */
+            addToPool(Us, PAWN);
+            undo.captured |= PROMOTED_CAPTURE;
+        } else {
+            addToPool(Us, getPiece(board[dst]));
+        }
+        removePiece(dst);
+    } else if (move.isEnPassant()) {
+        addToPool(Us, PAWN);
+        removePiece(makeSquare(rankOf(src), fileOf(dst)));
+    }
+
+    /* for castling */
+    if (pieceToMove == KING) {
+        clearCastleRight(Us, 0);
+        clearCastleRight(Us, 1);
+
+        if (move.isCastle()) { /* move rook when castling */
+            int col = (fileOf(src) - fileOf(dst) > 0) ? 1 : 8;
+            int diff = (fileOf(src) - fileOf(dst) > 0) ? 3 : -2;
+            relocatePiece(makeSquare(rankOf(src), col), makeSquare(rankOf(src), col + diff));
+        }
+    }
+
+    /* a rook that leaves its corner, or is captured there, can no longer castle */
+    static constexpr Bitboard cornersBB = squareBB(makeSquare(1, 1)) | squareBB(makeSquare(1, 8)) |
+                                          squareBB(makeSquare(8, 1)) | squareBB(makeSquare(8, 8));
+    if ((squareBB(src) | squareBB(dst)) & cornersBB) {
+        static constexpr int corners[2][2] = {{makeSquare(8, 1), makeSquare(8, 8)}, {makeSquare(1, 1), makeSquare(1, 8)}};
+        for (int side = 0; side < 2; side++)
+            for (int type = 0; type < 2; type++)
+                if (src == corners[side][type] || dst == corners[side][type])
+                    clearCastleRight(PlaySide(side), type);
+    }
+
+    if (move.isPromotion()) {
+        removePiece(src);
+        putPiece(dst, getBoardPiece(move.getReplacement(), Us));
+        setPromoted(dst);
+    } else {
+        relocatePiece(src, dst);
+    }
+
+    if (pieceToMove == PAWN && abs(rankOf(dst) - rankOf(src)) == 2)
+        setEnPassantSquare((src + dst) / 2);
+
+    switchSideToMove();
+}
+
+/**
+ * Return board to the previous configuration, before move was performed. The pieces are put back
+ * one by one, everything else is copied from the undo record.
+ * @param move move
+ * @param undo record filled by makeMove
+*/
+void Position::undoMove(PackedMove move, const UndoRecord &undo) {
+    if (sideToMove == WHITE)
+        undoMove<BLACK>(move, undo);
+    else
+        undoMove<WHITE>(move, undo);
+}
+
+template <PlaySide Us>
+void Position::undoMove(PackedMove move, const UndoRecord &undo) {
+    sideToMove = Us;
+    int dst = move.getDestination();
+
+    if (move.isDropIn()) {
+        removePiece(dst);
+        addToPool(Us, move.getReplacement());
+    } else {
+        int src = move.getSource();
+
+        if (move.isPromotion()) {
+            removePiece(dst);
+            putPiece(src, getBoardPiece(PAWN, Us));
+        } else {
+            relocatePiece(dst, src);
+        }
+
+        if (move.isCastle()) {  /* move the rook back to its corner */
+            int col = (fileOf(src) - fileOf(dst) > 0) ? 1 : 8;
+            int diff = (fileOf(src) - fileOf(dst) > 0) ? 3 : -2;
+            relocatePiece(makeSquare(rankOf(src), col + diff), makeSquare(rankOf(src), col));
+        }
+
+        if (undo.captured != EMPTY) {  /* capture piece */
+            if (undo.captured & PROMOTED_CAPTURE) {
+                takeFromPool(Us, PAWN);
+                putPiece(dst, undo.captured & ~PROMOTED_CAPTURE);
+                setPromoted(dst);
+            } else {
+                takeFromPool(Us, getPiece(undo.captured));
+                putPiece(dst, undo.captured);
+            }
+        } else if (move.isEnPassant()) {
+            takeFromPool(Us, PAWN);
+            putPiece(makeSquare(rankOf(src), fileOf(dst)), getBoardPiece(PAWN, opponentOf(Us)));
+        }
+    }
+
+    key = undo.key;
+    psqScore[WHITE] = undo.psqScore[WHITE];
+    psqScore[BLACK] = undo.psqScore[BLACK];
+    enPassantSquare = undo.enPassantSquare;
+    moveCount = undo.moveCount;
+    memcpy(castlePossible, undo.castlePossible, sizeof(castlePossible));
+}
+
+/**
+ * Pass the turn to the opponent, for null-move pruning. Only the side to move and the en passant
+ * square change.
+ * @param undo filled with the state needed by undoNullMove
+*/
+void Position::makeNullMove(UndoRecord &undo) {
+    undo.key = key;
+    undo.enPassantSquare = enPassantSquare;
+
+    setEnPassantSquare(NO_SQUARE);
+    switchSideToMove();
+}
+
+/**
+ * Take back a null move performed with makeNullMove.
+ * @param undo state saved by makeNullMove
+*/
+void Position::undoNullMove(const UndoRecord &undo) {
+    sideToMove = getOpponentPlaySide(sideToMove);
+    key = undo.key;
+    enPassantSquare = undo.enPassantSquare;
+}
+
+/* the specializations called by the search */
+template void Position::generateAllMoves<WHITE>(MoveList &moves);
+template void Position::generateAllMoves<BLACK>(MoveList &moves);
+template void Position::generateCaptures<WHITE>(MoveList &moves);
+template void Position::generateCaptures<BLACK>(MoveList &moves);
+template void Position::generateQuiets<WHITE>(MoveList &moves);
+template void Position::generateQuiets<BLACK>(MoveList &moves);
+template void Position::generateDrops<WHITE>(MoveList &moves);
+template void Position::generateDrops<BLACK>(MoveList &moves);
+template bool Position::isLegal<WHITE>(PackedMove move);
+template bool Position::isLegal<BLACK>(PackedMove move);
+template void Position::generateEvasions<WHITE>(MoveList &moves);
+template void Position::generateEvasions<BLACK>(MoveList &moves);
+template void Position::generateCheckingDrops<WHITE>(MoveList &moves, int limit);
+template void Position::generateCheckingDrops<BLACK>(MoveList &moves, int limit);
+template void Position::makeMove<WHITE>(PackedMove move, UndoRecord &undo);
+template void Position::makeMove<BLACK>(PackedMove move, UndoRecord &undo);
+template void Position::undoMove<WHITE>(PackedMove move, const UndoRecord &undo);
+template void Position::undoMove<BLACK>(PackedMove move, const UndoRecord &undo);
@@ -0,0 +1,229 @@
+#ifndef POSITION_H
+#define POSITION_H
+#include <bits/stdc++.h>
+
+#include "Bitboard.h"
+#include "Move.h"
+#include "MoveList.h"
+#include "PackedMove.h"
+#include "Piece.h"
+#include "PlaySide.h"
+
+#define BOARD_SIZE 8
+
+#define PROMOTED_CAPTURE 16  /* set in UndoRecord::captured if the captured piece was a promoted pawn */
+
+enum BoardPiece {
+    WHITE_PAWN = 1, WHITE_ROOK = 2, WHITE_BISHOP = 3,
+    WHITE_KNIGHT = 4, WHITE_QUEEN = 5, WHITE_KING = 6,
+    BLACK_PAWN = 7, BLACK_ROOK = 8, BLACK_BISHOP = 9,
+    BLACK_KNIGHT = 10, BLACK_QUEEN = 11, BLACK_KING = 12,
+    EMPTY = 0
+};
+
+/* the state makeMove cannot recompute backwards, saved so that undoMove restores it exactly */
+typedef struct {
+    uint64_t key;              /* Zobrist key */
+    int psqScore[2];           /* material and piece-square scores */
+    int captured;              /* BoardPiece captured by the move (PROMOTED_CAPTURE set for a promoted pawn), EMPTY if none */
+    int enPassantSquare;
+    int moveCount;
+    bool castlePossible[2][2];
+} UndoRecord;
+
+/*
+  A crazyhouse position: board, pockets, castling rights, en passant square, halfmove clock
+  and side to move. Self-contained and copyable, so every search can work on its own copy.
+ */
+class Position {
+ public:
+    Bitboard pieces[2][6];  /* pieces[playSide][piece] - squares occupied by piece of color playSide */
+    Bitboard occupied[2];   /* squares occupied by any piece of one color */
+    Bitboard occupiedAll;   /* occupied[BLACK] | occupied[WHITE] */
+    Bitboard promoted;      /* promoted pawns, which go back to the pool as pawns when captured */
+
+    int board[SQUARES];     /* BoardPiece on each square, for O(1) lookup of the piece at a square */
+
+    int pool[2][5];  /* number of pieces captured and can be dropped */
+                     /* pool[PlaySide::BLACK] - black's pool
+                        pool[PlaySide::WHITE] - white's pool */
+
+    bool castlePossible[2][2];  /* 0 - Queen side castle, 1 - King side castle
+                                   castlePossible[PlaySide::WHITE][] - for WHITE's castling rights
+                                   castlePossible[PlaySide::BLACK][] - for BLACK's castling rights */
+
+    int enPassantSquare;  /* square skipped by a pawn that has just advanced two squares, NO_SQUARE otherwise */
+
+    int moveCount; /* number of moves (from the beginning of a game) without any captured pieces or pawns moved */
+
+    PlaySide sideToMove;
+
+    uint64_t key;  /* Zobrist key, updated incrementally with every change of the position */
+
+    int psqScore[2];  /* psqScore[playSide] - material and piece-square score of the pieces on the board and
+                         in the pocket of playSide, updated incrementally */
+
+    /**
+     * Initialize the position at the start of a game.
+     */
+    Position();
+
+    /**
+     * Set up the position described by a crazyhouse FEN, with pockets and promoted pieces.
+     * @return false if the FEN is not valid
+     */
+    bool setFEN(const std::string &fen);
+
+    uint64_t computeKey();
+
+    static int getBoardPiece(Piece piece, PlaySide playSide);
+
+    static PlaySide getPlaySide(int value);
+
+    static Piece getPiece(int value);
+
+    static PlaySide getOpponentPlaySide(PlaySide playSide);
+
+    int getKingSquare(PlaySide playSide);
+
+    bool isSquareAttacked(int sq, PlaySide attacker, Bitboard occupancy);
+
+    Bitboard attackersTo(int sq, PlaySide attacker, Bitboard occupancy);
+
+    Bitboard getCheckers(PlaySide playSide);
+
+    Bitboard getPinned(PlaySide playSide);
+
+    bool inCheck(PlaySide playSide);
+
+    /**
+     * Check whether a move of the side to move captures a piece.
+     */
+    bool isCapture(PackedMove move);
+
+    /**
+     * Generate all legal moves of the side to move, castles included.
+     * @param moves list filled with the moves
+     */
+    void generateAllMoves(MoveList &moves);
+
+    void generateCaptures(MoveList &moves);
+
+    void generateQuiets(MoveList &moves);
+
+    void generateDrops(MoveList &moves);
+
+    void generateEvasions(MoveList &moves);
+
+    void generateCheckingDrops(MoveList &moves, int limit);
+
+    bool isLegal(PackedMove move);
+
+    /* the same generators, for a side to move Us known at compile time */
+    template <PlaySide Us>
+    void generateAllMoves(MoveList &moves);
+
+    template <PlaySide Us>
+    void generateCaptures(MoveList &moves);
+
+    template <PlaySide Us>
+    void generateQuiets(MoveList &moves);
+
+    template <PlaySide Us>
+    void generateDrops(MoveList &moves);
+
+    template <PlaySide Us>
+    void generateEvasions(MoveList &moves);
+
+    template <PlaySide Us>
+    void generateCheckingDrops(MoveList &moves, int limit);
+
+    template <PlaySide Us>
+    bool isLegal(PackedMove move);
+
+    /**
+     * Perform a move: board, pockets, castling rights, en passant square, halfmove clock,
+     * key and scores.
+     * @param undo filled with the state needed by undoMove
+     */
+    void makeMove(PackedMove move, UndoRecord &undo);
+
+    /**
+     * Take back the last move performed with makeMove.
+     * @param undo state saved by makeMove
+     */
+    void undoMove(PackedMove move, const UndoRecord &undo);
+
+    /* the same, for a move of Us known at compile time (Us is still the side to move before undoMove) */
+    template <PlaySide Us>
+    void makeMove(PackedMove move, UndoRecord &undo);
+
+    template <PlaySide Us>
+    void undoMove(PackedMove move, const UndoRecord &undo);
+
+    /**
+     * Let the opponent move twice in a row (null move), without touching the board.
+     * @param undo filled with the state needed by undoNullMove
+     */
+    void makeNullMove(UndoRecord &undo);
+
+    void undoNullMove(const UndoRecord &undo);
+
+    /**
+     * Play a move of the game, which is never taken back.
+     */
+    void doMove(PackedMove move);
+
+    /**
+     * Pack a move received from xboard, flagging castles and en passant captures
+     * according to the board.
+     */
+    PackedMove parseMove(Move* move);
+
+ private:
+    void clear();
+
+    void putPiece(int sq, int value);
+
+    void removePiece(int sq);
+
+    void relocatePiece(int src, int dst);
+
+    void setPromoted(int sq);
+
+    void addToPool(PlaySide playSide, Piece piece);
+
+    void takeFromPool(PlaySide playSide, Piece piece);
+
+    void switchSideToMove();
+
+    void clearCastleRight(PlaySide playSide, int type);
+
+    void setEnPassantSquare(int sq);
+
+    template <PlaySide Us>
+    bool spaceForCastle(int type);
+
+    template <PlaySide Us>
+    void pushCastles(int kingSquare, MoveList &moves);
+
+    bool landsInCheck(PackedMove move, PlaySide playSide);
+
+    bool enPassantRights(int src, int dst);
+
+    void pushPieceMoves(int src, Bitboard targets, MoveList &moves);
+
+    void pushPromotions(int src, int dst, MoveList &moves);
+
+    void pushUnderpromotions(int src, int dst, MoveList &moves);
+
+    template <PlaySide Us>
+    void pushCaptures(Bitboard checkers, Bitboard pinned, MoveList &moves);
+
+    template <PlaySide Us>
+    void pushQuiets(Bitboard checkers, Bitboard pinned, MoveList &moves);
+
+    template <PlaySide Us>
+    void pushDrops(Bitboard checkers, MoveList &moves);
+};
+#endif
@@ -0,0 +1,745 @@
+#include "SearchContext.h"
+
+#include <bits/stdc++.h>
+
+#include "AllocationCounter.h"
+
+/* lmrReductions[depth][index] - depth reduction of the quiet move searched at index, at given depth */
+static int lmrReductions[MAX_DEPTH + 1][64];
+
+/* lateMoveCounts[depth] - quiet moves searched at a frontier node before the rest are pruned */
+static int lateMoveCounts[FUTILITY_DEPTH + 1];
+
+/**
+ * Fill the reduction tables: reductions grow with the logarithm of both the depth and the index
+ * of the move, so that late moves of deep nodes lose the most.
+*/
+void initSearch() {
+    for (int depth = 0; depth <= MAX_DEPTH; depth++)
+        for (int index = 0; index < 64; index++)
+            lmrReductions[depth][index] = (depth == 0 || index == 0) ? 0 :
+                                          (int)(0.75 + log(depth) * log(index) / 2.25);
+
+    for (int depth = 0; depth <= FUTILITY_DEPTH; depth++)
+        lateMoveCounts[depth] = 5 + 3 * depth * depth;
+}
+
+/**
+ * Make a mate score relative to the node before it is stored in the transposition table, so that
+ * it is still right when the position is reached at another ply.
+*/
+static int scoreToTT(int score, int ply) {
+    return (score >= MATE_BOUND) ? score + ply : (score <= -MATE_BOUND) ? score - ply : score;
+}
+
+/**
+ * Make a mate score read from the transposition table relative to the root again.
+*/
+static int scoreFromTT(int score, int ply) {
+    return (score >= MATE_BOUND) ? score - ply : (score <= -MATE_BOUND) ? score + ply : score;
+}
+
+/**
+ * Create a search context.
+ * @param transpositionTable table used by the search, shared with the other threads
+ * @param stopSignal flag raised by the main thread to stop all the threads
+ * @param id thread index, 0 for the main thread
+ * @param threads contexts of all the search threads, whose nodes the reports add up
+*/
+SearchContext::SearchContext(TranspositionTable *transpositionTable, std::atomic<bool> *stopSignal, int id,
+                             const std::vector<SearchContext*> *threads) {
+    this->transpositionTable = transpositionTable;
+    this->stopSignal = stopSignal;
+    this->id = id;
+    this->threads = threads;
+
+    nodes = 0;
+    post = false;
+    rootDepth = rootMoves = rootMovesSearched = 0;
+
+    memset(history, 0, sizeof(history));
+    memset(dropHistory, 0, sizeof(dropHistory));
+}
+
+/**
+ * Search the best move of the side to move, on a copy of rootPosition, deepening one ply at a time
+ * until the time manager says otherwise. Each iteration starts with a narrow window around the previous
+ * score, widened until the score fits. An interrupted iteration is discarded, except for the first one.
+ * Helper threads run the same loop, odd ones one ply ahead, and only stop on the stop signal: they
+ * are useful through the entries they leave in the shared transposition table.
+ * @param rootPosition position to search
+ * @param timeManager limits of the search, already started
+ * @returns the best move found, NO_MOVE if there are no legal moves
+*/
+PackedMove SearchContext::search(const Position &rootPosition, TimeManager &timeManager) {
+    position = rootPosition;
+    bestMove = ponderMove = NO_MOVE;
+
+    this->timeManager = &timeManager;
+    nodes = 0;
+    stopped = false;
+
+    for (int ply = 0; ply < MAX_PLY; ply++)
+        killers[ply][0] = killers[ply][1] = NO_MOVE;
+
+    /* negamax generates the moves stage by stage, count the root moves once for the status reports */
+    position.generateAllMoves(stack[0].moves);
+    rootMoves.store(stack[0].moves.size, std::memory_order_relaxed);
+
+#ifdef COUNT_ALLOCATIONS
+    size_t allocations = getAllocationCount();
+#endif
+    int score = 0, stability = 0;
+    int maxDepth = timeManager.getDepthLimit() > 0 ? std::min(timeManager.getDepthLimit(), MAX_DEPTH) : MAX_DEPTH;
+
+    for (int depth = 1 + id % 2; depth <= maxDepth; depth++) {
+        rootDepth.store(depth, std::memory_order_relaxed);
+
+        int window = ASPIRATION_WINDOW;
+        int alpha = (depth > 1) ? score - window : -INF;
+        int beta = (depth > 1) ? score + window : INF;
+
+        while (true) {
+            score = (position.sideToMove == WHITE) ? negamax<WHITE>(alpha, beta, depth, 0)
+                                                   : negamax<BLACK>(alpha, beta, depth, 0);
+
+            if (stopped) {
+                break;
+            } else if (score <= alpha) {  /* fail low */
+                window *= 2;
+                alpha = std::max(score - window, -INF);
+            } else if (score >= beta) {  /* fail high */
+                window *= 2;
+                beta = std::min(score + window, INF);
+            } else {
+                break;
+            }
+        }
+
+        if (stopped)
+            break;
+
+        if (pvLength[0] > 0) {
+            stability = (pvTable[0][0] == bestMove) ? stability + 1 : 0;
+            bestMove = pvTable[0][0];
+            ponderMove = (pvLength[0] > 1) ? pvTable[0][1] : NO_MOVE;
+        }
+
+        if (id == 0 && post)
+            printThinking(depth, score);
+
+        if (id == 0 && timeManager.softLimitReached(stability))
+            break;
+    }
+#ifdef COUNT_ALLOCATIONS
+    /* the search works only with the preallocated stack */
+    assert(getAllocationCount() == allocations);
+#endif
+
+    return bestMove;
+}
+
+/**
+ * Evaluation function of the search, a few additions on the sums kept by the position.
+ * @tparam Us side to move
+ * @returns the heuristic value of the board configuration, from the side to move's point of view
+*/
+template <PlaySide Us>
+int SearchContext::evaluate() {
+    return position.psqScore[Us] - position.psqScore[opponentOf(Us)];
+}
+
+/**
+ * Store move as the best move at ply, followed by the best line found from ply + 1.
+ * @param ply ply of the move
+ * @param move best move at ply
+*/
+void SearchContext::updatePV(int ply, PackedMove move) {
+    pvTable[ply][ply] = move;
+
+    for (int i = ply + 1; i < pvLength[ply + 1]; i++)
+        pvTable[ply][i] = pvTable[ply + 1][i];
+
+    pvLength[ply] = pvLength[ply + 1];
+}
+
+/**
+ * Get the history score of a quiet move of Us, the side to move.
+*/
+template <PlaySide Us>
+int& SearchContext::historyOf(PackedMove move) {
+    if (move.isDropIn())
+        return dropHistory[Us][move.getReplacement()][move.getDestination()];
+
+    return history[Us][move.getSource()][move.getDestination()];
+}
+
+/**
+ * Add bonus (negative for a penalty) to the history of a quiet move, scaled down as the score
+ * approaches HISTORY_MAX so that it never overflows and recent results weigh more.
+*/
+template <PlaySide Us>
+void SearchContext::updateHistory(PackedMove move, int bonus) {
+    int &entry = historyOf<Us>(move);
+    entry += bonus - entry * abs(bonus) / HISTORY_MAX;
+}
+
+/**
+ * Give each move of the current stage of the frame an ordering score: captures and promotions by most
+ * valuable victim / least valuable attacker, above the quiet moves and drops, ordered by history.
+ * @param frame frame with the moves of the stage generated from frame.stageStart on
+*/
+template <PlaySide Us>
+void SearchContext::scoreMoves(SearchFrame &frame) {
+    for (int i = frame.stageStart; i < frame.moves.size; i++) {
+        PackedMove move = frame.moves[i];
+        int64_t score;
+
+        if (position.isCapture(move) || move.isPromotion()) {
+            int victim = move.isEnPassant() ? POINTS_PAWN :
+                         position.board[move.getDestination()] != EMPTY ?
+                         pieceValue[Position::getPiece(position.board[move.getDestination()])] : 0;
+            int attacker = pieceValue[Position::getPiece(position.board[move.getSource()])];
+
+            score = CAPTURE_SCORE + victim * 128 - attacker;
+            if (move.isPromotion())
+                score += pieceValue[move.getReplacement()] * 128;
+        } else {
+            score = historyOf<Us>(move);
+        }
+
+        frame.scores[i] = score * 65536 | move.data;  /* score << 16, defined for negative history scores too */
+    }
+}
+
+/**
+ * Get the next move of the current stage: the first SELECTION_PICKS moves are found by selection,
+ * which is cheap when one of them causes a cutoff, then the remaining moves are sorted at once.
+ * @returns the move to search next, there must be one left in the stage
+*/
+PackedMove SearchContext::pickMove(SearchFrame &frame) {
+    int index = frame.current++, size = frame.moves.size;
+    int picked = index - frame.stageStart;
+
+    if (picked < SELECTION_PICKS) {
+        int best = index;
+
+        for (int i = index + 1; i < size; i++)
+            if (frame.scores[i] > frame.scores[best])
+                best = i;
+
+        std::swap(frame.scores[index], frame.scores[best]);
+        frame.moves[index] = PackedMove(frame.scores[index] & 0xFFFF);
+    } else if (picked == SELECTION_PICKS) {
+        std::sort(frame.scores + index, frame.scores + size, std::greater<int64_t>());
+
+        for (int i = index; i < size; i++)
+            frame.moves[i] = PackedMove(frame.scores[i] & 0xFFFF);
+    }
+
+    return frame.moves[index];
+}
+
+/**
+ * Staged move picker of negamax: the hash move is tried before anything is generated, then the captures,
+ * the killers, the drops and the other quiet moves, each group generated only when the moves before
+ * it did not cause a cutoff. Most cut nodes never generate the drops, the bulk of crazyhouse moves.
+ * The frame must be set up with the hash move and stage STAGE_HASH_MOVE, or STAGE_EVASION_HASH_MOVE
+ * if the side to move is in check.
+ * @tparam Us side to move
+ * @param frame frame of the node
+ * @param ply distance from the root
+ * @returns the next legal move to search, NO_MOVE when all of them have been picked
+*/
+template <PlaySide Us>
+PackedMove SearchContext::nextMove(SearchFrame &frame, int ply) {
+    PackedMove move;
+
+    switch (frame.stage) {
+    case STAGE_HASH_MOVE:
+        frame.stage = STAGE_GENERATE_CAPTURES;
+
+        /* the stored move may come from another position with the same index */
+        if (frame.hashMove != NO_MOVE && position.isLegal<Us>(frame.hashMove))
+            return frame.hashMove;
+        [[fallthrough]];
+
+    case STAGE_GENERATE_CAPTURES:
+        position.generateCaptures<Us>(frame.moves);
+        frame.current = frame.stageStart = 0;
+        scoreMoves<Us>(frame);
+        frame.stage = STAGE_CAPTURES;
+        [[fallthrough]];
+
+    case STAGE_CAPTURES:
+        while (frame.current < frame.moves.size)
+            if ((move = pickMove(frame)) != frame.hashMove)
+                return move;
+
+        frame.killerIndex = 0;
+        frame.stage = STAGE_KILLERS;
+        [[fallthrough]];
+
+    case STAGE_KILLERS:
+        /* killers come from sibling positions, they may be illegal or captures here */
+        while (frame.killerIndex < 2) {
+            move = killers[ply][frame.killerIndex++];
+
+            if (move != NO_MOVE && move != frame.hashMove && !position.isCapture(move) &&
+                !move.isPromotion() && position.isLegal<Us>(move))
+                return move;
+        }
+
+        frame.stage = STAGE_GENERATE_DROPS;
+        [[fallthrough]];
+
+    case STAGE_GENERATE_DROPS:
+        frame.current = frame.stageStart = frame.moves.size;
+        position.generateDrops<Us>(frame.moves);
+        scoreMoves<Us>(frame);
+        frame.stage = STAGE_DROPS;
+        [[fallthrough]];
+
+    case STAGE_DROPS:
+        while (frame.current < frame.moves.size)
+            if ((move = pickMove(frame)) != frame.hashMove && move != killers[ply][0] && move != killers[ply][1])
+                return move;
+
+        frame.stage = STAGE_GENERATE_QUIETS;
+        [[fallthrough]];
+
+    case STAGE_GENERATE_QUIETS:
+        frame.current = frame.stageStart = frame.moves.size;
+        position.generateQuiets<Us>(frame.moves);
+        scoreMoves<Us>(frame);
+        frame.stage = STAGE_QUIETS;
+        [[fallthrough]];
+
+    case STAGE_QUIETS:
+        while (frame.current < frame.moves.size)
+            if ((move = pickMove(frame)) != frame.hashMove && move != killers[ply][0] && move != killers[ply][1])
+                return move;
+
+        frame.stage = STAGE_DONE;
+        return NO_MOVE;
+
+    case STAGE_EVASION_HASH_MOVE:
+        frame.stage = STAGE_GENERATE_EVASIONS;
+
+        if (frame.hashMove != NO_MOVE && position.isLegal<Us>(frame.hashMove))
+            return frame.hashMove;
+        [[fallthrough]];
+
+    case STAGE_GENERATE_EVASIONS:
+        /* few moves get out of check, they are generated and ordered together */
+        position.generateEvasions<Us>(frame.moves);
+        frame.current = frame.stageStart = 0;
+        scoreMoves<Us>(frame);
+        frame.stage = STAGE_EVASIONS;
+        [[fallthrough]];
+
+    case STAGE_EVASIONS:
+        while (frame.current < frame.moves.size)
+            if ((move = pickMove(frame)) != frame.hashMove)
+                return move;
+
+        frame.stage = STAGE_DONE;
+        return NO_MOVE;
+
+    default:
+        return NO_MOVE;
+    }
+}
+
+/**
+ * Count a node and stop the search if the hard limit is reached or the main thread has finished.
+ * The first iteration of the main thread is never interrupted, so that there always is a move to play.
+ * @returns true if the search must unwind
+*/
+bool SearchContext::checkTime() {
+    /* only this thread writes nodes, so a plain load and store are enough */
+    uint64_t visited = nodes.load(std::memory_order_relaxed) + 1;
+    nodes.store(visited, std::memory_order_relaxed);
+
+    if ((visited & CHECK_TIME_NODES) == 0) {
+        if (id == 0 && bestMove != NO_MOVE && timeManager->hardLimitReached())
+            stopSignal->store(true, std::memory_order_relaxed);
+
+        if (stopSignal->load(std::memory_order_relaxed))
+            stopped = true;
+    }
+
+    return stopped;
+}
+
+uint64_t SearchContext::getNodes() {
+    return nodes.load(std::memory_order_relaxed);
+}
+
+uint64_t SearchContext::getTotalNodes() {
+    uint64_t total = 0;
+    for (SearchContext *thread : *threads)
+        total += thread->getNodes();
+
+    return total;
+}
+
+void SearchContext::getProgress(int &depth, int &movesLeft, int &movesTotal) {
+    depth = rootDepth.load(std::memory_order_relaxed);
+    movesTotal = rootMoves.load(std::memory_order_relaxed);
+    movesLeft = std::max(movesTotal - rootMovesSearched.load(std::memory_order_relaxed), 0);
+}
+
+void SearchContext::setPost(bool post) {
+    this->post = post;
+}
+
+/**
+ * Print the result of an iteration in xboard's format: depth, score (centipawns), time (centiseconds),
+ * nodes of all the threads and principal variation. The line is put together in a buffer and written at once, since the
+ * search may run next to the thread talking to xboard, and flushed, since nothing else would flush it.
+ * @param depth depth of the iteration
+ * @param score score of the iteration
+*/
+void SearchContext::printThinking(int depth, int score) {
+    char line[64 + MAX_PLY * 6];
+    int length = snprintf(line, 64, "%d %d %lld %llu", depth, score,
+                          (long long)(timeManager->elapsed() / 10), (unsigned long long)getTotalNodes());
+
+    for (int i = 0; i < pvLength[0]; i++) {
+        std::string move = pvTable[0][i].toString();  /* short enough for the string not to allocate */
+        line[length++] = ' ';
+        memcpy(line + length, move.data(), move.size());
+        length += move.size();
+    }
+    line[length++] = '\n';
+
+    std::cout.write(line, length);
+    std::cout.flush();
+}
+
+/**
+ * Get the expected reply to the best move: the second move of the principal variation of the last
+ * completed iteration or, if the line stops at the best move (the reply did not raise alpha), the move
+ * stored in the transposition table for the position after it.
+ * @returns the expected reply, NO_MOVE if there is none
+*/
+PackedMove SearchContext::getPonderMove() {
+    if (ponderMove != NO_MOVE || bestMove == NO_MOVE)
+        return ponderMove;
+
+    TTEntry entry;
+    UndoRecord undo;
+    position.makeMove(bestMove, undo);
+
+    /* the stored move may come from another position with the same index, keep it only if legal */
+    if (transpositionTable->probe(position.key, entry) && entry.move != NO_MOVE) {
+        MoveList &moves = stack[0].moves;
+        position.generateAllMoves(moves);
+
+        for (int i = 0; i < moves.size; i++)
+            if (moves[i] == entry.move)
+                ponderMove = entry.move;
+    }
+
+    position.undoMove(bestMove, undo);
+    return ponderMove;
+}
+
+/**
+ * Points won by a capture or promotion: the captured piece, plus the promoted piece replacing a pawn.
+ * @param move move of the side to move
+*/
+int SearchContext::captureGain(PackedMove move) {
+    int gain = 0;
+
+    if (move.isEnPassant())
+        gain = POINTS_PAWN;
+    else if (!move.isDropIn() && position.board[move.getDestination()] != EMPTY)
+        gain = pieceValue[Position::getPiece(position.board[move.getDestination()])];
+
+    if (move.isPromotion())
+        gain += pieceValue[move.getReplacement()] - POINTS_PAWN;
+
+    return gain;
+}
+
+/**
+ * Check whether the side to move has only its king and pawns, on the board and in its pocket: the
+ * positions where passing would be an advantage (zugzwang), so the null move proves nothing.
+*/
+template <PlaySide Us>
+bool SearchContext::zugzwangRisk() {
+    for (int piece = ROOK; piece <= QUEEN; piece++)
+        if (position.pieces[Us][piece] || position.pool[Us][piece])
+            return false;
+
+    return true;
+}
+
+/**
+ * Check whether a move is a drop far from both kings that never caused a cutoff: most of the drops
+ * of a crazyhouse position, and rarely good ones. Build with NO_DROP_PRUNING to search them like
+ * the other quiet moves.
+ * @tparam Us side to move
+*/
+template <PlaySide Us>
+bool SearchContext::remoteDrop(PackedMove move) {
+#ifdef NO_DROP_PRUNING
+    return false;
+#else
+    int dst = move.getDestination();
+
+    return move.isDropIn() && historyOf<Us>(move) <= 0 &&
+           distance(dst, position.getKingSquare(Us)) > DROP_KING_DISTANCE &&
+           distance(dst, position.getKingSquare(opponentOf(Us))) > DROP_KING_DISTANCE;
+#endif
+}
+
+/**
+ * Search only captures and promotions (and, at its first ply, a few checking drops) until the position
+ * is quiet, so that the evaluation is never taken in the middle of an exchange. The side to move may
+ * also stand pat, i.e. keep the static evaluation, if no capture improves on it, unless it is in check:
+ * then all the evasions are searched, and a position without any is checkmate.
+ * @tparam Us side to move
+ * @param alpha lower bound of the score the side to move is already guaranteed
+ * @param beta upper bound of the score, above which the opponent avoids this line
+ * @param ply distance from the root
+ * @param checkingDrops whether to add checking drops to the captures
+ * @returns the score of the position, from the side to move's point of view
+*/
+template <PlaySide Us>
+int SearchContext::quiescence(int alpha, int beta, int ply, bool checkingDrops) {
+    constexpr PlaySide Them = opponentOf(Us);
+    pvLength[ply] = ply;
+
+    if (checkTime())
+        return 0;
+
+    int standPat = evaluate<Us>();
+
+    if (ply == MAX_PLY - 1)
+        return standPat;
+
+    SearchFrame &frame = stack[ply];
+    MoveList &moves = frame.moves;
+    bool inCheck = position.inCheck(Us);
+    int bestScore;
+
+    if (inCheck) {
+        bestScore = -INF;
+        position.generateEvasions<Us>(moves);
+    } else {
+        if (standPat >= beta)
+            return standPat;
+
+        if (standPat > alpha)
+            alpha = standPat;
+
+        bestScore = standPat;
+        position.generateCaptures<Us>(moves);
+        if (checkingDrops)
+            position.generateCheckingDrops<Us>(moves, QS_CHECKING_DROPS);
+    }
+
+    frame.current = frame.stageStart = 0;
+    scoreMoves<Us>(frame);
+
+    while (frame.current < moves.size) {
+        PackedMove currentMove = pickMove(frame);
+
+        /* delta pruning: even winning the piece for free would not reach alpha */
+        if (!inCheck && !currentMove.isDropIn() && standPat + captureGain(currentMove) + DELTA_MARGIN <= alpha)
+            continue;
+
+        position.makeMove<Us>(currentMove, frame.undo);
+        int score = -quiescence<Them>(-beta, -alpha, ply + 1, false);
+        position.undoMove<Us>(currentMove, frame.undo);
+
+        if (stopped)
+            return 0;
+
+        if (score > bestScore) {
+            bestScore = score;
+
+            if (score > alpha) {
+                alpha = score;
+                updatePV(ply, currentMove);
+
+                if (alpha >= beta)
+                    break;
+            }
+        }
+    }
+
+    if (bestScore == -INF)  /* checkmate */
+        return -MATE_SCORE + ply;
+
+    return bestScore;
+}
+
+/**
+ * Use negamax alpha-beta with principal variation search: the first move is searched with the full
+ * window, the others with a null window that only proves they are not better, and are re-searched
+ * if the proof fails. In check, only the evasions are generated, and a node without any is checkmate.
+ * Outside the principal variation and out of check, the search is selective:
+ * - null-move pruning: if the side to move is still above beta after passing the turn, searched to
+ *   a reduced depth, the node is cut (not tried without pieces, where passing may be an advantage);
+ * - late move reductions: quiet moves ordered late are searched to a lower depth, and re-searched
+ *   to the full depth only if they beat alpha;
+ * - futility and late move pruning: near the horizon, quiet moves are skipped when the evaluation
+ *   is far below alpha, or once enough of them have been tried. Checking moves are never skipped;
+ * - drop pruning: drops far from both kings that never caused a cutoff are reduced one more ply,
+ *   and skipped near the horizon.
+ * @tparam Us side to move
+ * @param alpha lower bound of the score the side to move is already guaranteed
+ * @param beta upper bound of the score, above which the opponent avoids this line
+ * @param depth remaining depth
+ * @param ply distance from the root
+ * @returns the score of the position, from the side to move's point of view
+*/
+template <PlaySide Us>
+int SearchContext::negamax(int alpha, int beta, int depth, int ply) {
+    constexpr PlaySide Them = opponentOf(Us);
+    pvLength[ply] = ply;
+
+    if (checkTime())
+        return 0;
+
+    if (depth == 0)  /* resolve the captures left at the horizon */
+        return quiescence<Us>(alpha, beta, ply, true);
+
+    if (ply == MAX_PLY - 1)
+        return evaluate<Us>();
+
+    /* a deep enough stored result decides the node, except on the principal variation */
+    TTEntry entry;
+    PackedMove hashMove = NO_MOVE;
+    bool pvNode = beta - alpha > 1;
+
+    if (transpositionTable->probe(position.key, entry)) {
+        hashMove = entry.move;
+
+        if (!pvNode && entry.depth >= depth &&
+            (entry.bound == BOUND_EXACT ||
+             (entry.bound == BOUND_LOWER && scoreFromTT(entry.score, ply) >= beta) ||
+             (entry.bound == BOUND_UPPER && scoreFromTT(entry.score, ply) <= alpha)))
+            return scoreFromTT(entry.score, ply);
+    }
+
+    SearchFrame &frame = stack[ply];
+    int staticEval = evaluate<Us>();
+    bool inCheck = position.inCheck(Us);
+
+    /* null-move pruning, never twice in a row, nor in check */
+    if (!pvNode && !inCheck && ply > 0 && depth >= NULL_MOVE_MIN_DEPTH && staticEval >= beta &&
+        stack[ply - 1].move != NO_MOVE && !zugzwangRisk<Us>()) {
+        int reduction = NULL_MOVE_REDUCTION + depth / 4 + std::min((staticEval - beta) / 200, 2);
+
+        frame.move = NO_MOVE;
+        position.makeNullMove(frame.undo);
+        int score = -negamax<Them>(-beta, -beta + 1, std::max(depth - 1 - reduction, 0), ply + 1);
+        position.undoNullMove(frame.undo);
+
+        if (stopped)
+            return 0;
+
+        if (score >= beta)  /* a mate found after passing proves nothing about the real moves */
+            return (score >= MATE_BOUND) ? beta : score;
+    }
+
+    /* the moves are generated lazily, stage by stage, by nextMove */
+    frame.stage = inCheck ? STAGE_EVASION_HASH_MOVE : STAGE_HASH_MOVE;
+    frame.hashMove = hashMove;
+    frame.quietCount = 0;
+
+    int bestScore = -INF, originalAlpha = alpha;
+    PackedMove currentMove, bestNodeMove = NO_MOVE;
+    bool frontier = !pvNode && !inCheck && ply > 0 && depth <= FUTILITY_DEPTH;
+
+    for (int i = 0; (currentMove = nextMove<Us>(frame, ply)) != NO_MOVE; i++) {
+        bool quiet = !position.isCapture(currentMove) && !currentMove.isPromotion();
+        bool remote = !pvNode && !inCheck && i > 0 && remoteDrop<Us>(currentMove);
+        int score;
+
+        /* futility and late move pruning, decided before the move, applied if it does not give check */
+        bool prune = frontier && i > 0 && quiet && bestScore > -MATE_BOUND &&
+                     (remote || i >= lateMoveCounts[depth] || staticEval + FUTILITY_MARGIN * depth <= alpha);
+
+        if (ply == 0)
+            rootMovesSearched.store(i, std::memory_order_relaxed);
+
+        /* perform move */
+        frame.move = currentMove;
+        position.makeMove<Us>(currentMove, frame.undo);
+        bool givesCheck = position.inCheck(Them);
+
+        if (prune && !givesCheck) {
+            position.undoMove<Us>(currentMove, frame.undo);
+            continue;
+        }
+
+        /* only the moves actually searched are penalized in the history after a cutoff */
+        if (quiet && frame.quietCount < MAX_QUIETS_SEARCHED)
+            frame.quietsSearched[frame.quietCount++] = currentMove;
+
+        transpositionTable->prefetch(position.key);
+
+        if (i == 0) {
+            score = -negamax<Them>(-beta, -alpha, depth - 1, ply + 1);
+        } else {
+            /* late move reductions, less on the principal variation, more for remote drops */
+            int reduction = 0;
+            if (depth >= LMR_MIN_DEPTH && i >= LMR_FULL_MOVES && quiet && !givesCheck) {
+                reduction = lmrReductions[depth][std::min(i, 63)] - pvNode + remote;
+                reduction = std::max(std::min(reduction, depth - 2), 0);
+            }
+
+            score = -negamax<Them>(-alpha - 1, -alpha, depth - 1 - reduction, ply + 1);
+            if (reduction > 0 && score > alpha)
+                score = -negamax<Them>(-alpha - 1, -alpha, depth - 1, ply + 1);
+            if (score > alpha && score < beta)
+                score = -negamax<Them>(-beta, -alpha, depth - 1, ply + 1);
+        }
+
+        /* undo move */
+        position.undoMove<Us>(currentMove, frame.undo);
+
+        if (stopped)
+            return 0;
+
+        if (score > bestScore) {
+            bestScore = score;
+
+            if (score > alpha) {
+                alpha = score;
+                bestNodeMove = currentMove;
+                updatePV(ply, currentMove);
+
+                if (alpha >= beta) {  /* the opponent will not allow this line */
+                    if (quiet) {
+                        if (killers[ply][0] != currentMove) {
+                            killers[ply][1] = killers[ply][0];
+                            killers[ply][0] = currentMove;
+                        }
+
+                        /* reward the cutoff move, penalize the quiet moves tried before it */
+                        updateHistory<Us>(currentMove, depth * depth);
+                        for (int j = 0; j < frame.quietCount; j++)
+                            if (frame.quietsSearched[j] != currentMove)
+                                updateHistory<Us>(frame.quietsSearched[j], -depth * depth);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    if (bestScore == -INF)  /* no legal moves: checkmate, or stalemate */
+        return inCheck ? -MATE_SCORE + ply : 0;
+
+    Bound bound = (bestScore >= beta) ? BOUND_LOWER : (bestScore > originalAlpha) ? BOUND_EXACT : BOUND_UPPER;
+    transpositionTable->store(position.key, bestNodeMove, scoreToTT(bestScore, ply), depth, bound);
+
+    return bestScore;
+}
@@ -0,0 +1,187 @@
+#ifndef SEARCH_CONTEXT_H
+#define SEARCH_CONTEXT_H
+#include <bits/stdc++.h>
+
+#include "Evaluation.h"
+#include "MoveList.h"
+#include "PackedMove.h"
+#include "PlaySide.h"
+#include "Position.h"
+#include "TimeManager.h"
+#include "TranspositionTable.h"
+
+#define MAX_DEPTH 32  /* deepest iteration */
+#define MAX_PLY 64  /* size of the preallocated search stack */
+
+#define INF 1000000000
+#define MATE_SCORE 30000                    /* score of the side to move when checkmated at the root, less the plies to the mate */
+#define MATE_BOUND (MATE_SCORE - MAX_PLY)  /* scores beyond +/- MATE_BOUND are mates */
+
+#define ASPIRATION_WINDOW 25  /* initial half-width of the root window, around the previous iteration's score */
+
+#define DELTA_MARGIN 200      /* quiescence skips captures that cannot raise alpha even with this many extra points */
+#define QS_CHECKING_DROPS 8   /* checking drops tried at the first ply of the quiescence search */
+
+/* selective search */
+#define NULL_MOVE_MIN_DEPTH 3   /* null-move pruning is tried from this depth */
+#define NULL_MOVE_REDUCTION 3   /* base depth reduction of the null move search, grows with depth and eval */
+#define LMR_MIN_DEPTH 3         /* late move reductions are applied from this depth */
+#define LMR_FULL_MOVES 3        /* moves searched at full depth before the reductions start */
+#define FUTILITY_DEPTH 3        /* futility and late move pruning are applied up to this depth */
+#define FUTILITY_MARGIN 200     /* quiet moves are skipped when eval + FUTILITY_MARGIN * depth <= alpha */
+#define DROP_KING_DISTANCE 2    /* drops farther than this from both kings, without history, are reduced and pruned */
+
+#define CHECK_TIME_NODES 1023  /* the clock is checked every CHECK_TIME_NODES + 1 nodes */
+
+/* move ordering scores: captures and promotions (MVV / LVA) above quiet moves (history) */
+#define CAPTURE_SCORE (1 << 28)
+#define HISTORY_MAX (1 << 14)  /* history scores stay within [-HISTORY_MAX, HISTORY_MAX] */
+#define SELECTION_PICKS 4  /* moves of a stage picked one by one, before sorting the rest (most cutoffs come early) */
+#define MAX_QUIETS_SEARCHED 64  /* quiet moves remembered at each ply, penalized in the history after a cutoff */
+
+/* stages of the move picker: each group of moves is generated only if the ones before did not cut off;
+   in check, the hash move is followed by all the evasions at once */
+enum PickStage {
+    STAGE_HASH_MOVE, STAGE_GENERATE_CAPTURES, STAGE_CAPTURES, STAGE_KILLERS,
+    STAGE_GENERATE_DROPS, STAGE_DROPS, STAGE_GENERATE_QUIETS, STAGE_QUIETS,
+    STAGE_EVASION_HASH_MOVE, STAGE_GENERATE_EVASIONS, STAGE_EVASIONS, STAGE_DONE
+};
+
+/* per-ply search data, preallocated so that the search does not touch the heap */
+typedef struct {
+    MoveList moves;             /* moves generated at this ply, one stage after the other */
+    int64_t scores[MAX_MOVES];  /* ordering score of each move in moves, shifted left 16 bits, OR the move */
+    int stage;                  /* PickStage of the move picker */
+    int current;                /* index in moves of the next move to pick */
+    int stageStart;             /* index in moves of the first move of the current stage */
+    int killerIndex;            /* next killer to try, in STAGE_KILLERS */
+    PackedMove hashMove;        /* move stored in the transposition table, tried before any generation */
+    PackedMove quietsSearched[MAX_QUIETS_SEARCHED];  /* quiet moves searched at this ply, in order */
+    int quietCount;
+    UndoRecord undo;            /* undo record of the move currently searched */
+    PackedMove move;            /* move currently searched, NO_MOVE for a null move */
+} SearchFrame;
+
+/**
+ * Fill the late move reduction table. Must be called once, before any search.
+*/
+void initSearch();
+
+/*
+  State of one search thread: its own copy of the position, the per-ply stack and the ordering
+  tables. Only the transposition table and the stop signal are shared with the other threads.
+  The search functions are templated on the side to move (Us), which alternates with every ply.
+ */
+class SearchContext {
+ private:
+    Position position;  /* copy of the root position, modified by makeMove / undoMove */
+
+    PackedMove bestMove;    /* best move of the last completed iteration */
+    PackedMove ponderMove;  /* expected reply to bestMove, from the same iteration */
+
+    TranspositionTable *transpositionTable;  /* results of searched positions, kept between searches */
+
+    std::atomic<bool> *stopSignal;  /* shared by all the threads, raised by the main one */
+    int id;                         /* thread index, 0 for the main thread */
+
+    const std::vector<SearchContext*> *threads;  /* contexts of all the search threads, this one included */
+
+    TimeManager *timeManager;     /* limits of the current search */
+    std::atomic<uint64_t> nodes;  /* nodes visited by the current search, written only by its thread */
+    bool stopped;                 /* set when the search must stop, it then unwinds */
+
+    bool post;  /* print a line of thinking output after every iteration */
+
+    std::atomic<int> rootDepth;  /* depth of the current iteration, for status reports */
+    std::atomic<int> rootMoves;  /* number of root moves, and how many of them the current iteration searched */
+    std::atomic<int> rootMovesSearched;
+
+    SearchFrame stack[MAX_PLY];  /* stack[ply] - frame used by negamax at given ply */
+
+    PackedMove pvTable[MAX_PLY][MAX_PLY];  /* pvTable[ply] - best line found from ply, in pvTable[ply][ply..pvLength[ply]) */
+    int pvLength[MAX_PLY];
+
+    PackedMove killers[MAX_PLY][2];  /* quiet moves that caused the last beta cutoffs at each ply */
+
+    int history[2][SQUARES][SQUARES];  /* history[playSide][src][dst] - how often a quiet move caused a cutoff */
+    int dropHistory[2][5][SQUARES];    /* dropHistory[playSide][piece][dst] - the same, for drops */
+
+    template <PlaySide Us>
+    int evaluate();
+
+    void updatePV(int ply, PackedMove move);
+
+    template <PlaySide Us>
+    int& historyOf(PackedMove move);
+
+    template <PlaySide Us>
+    void updateHistory(PackedMove move, int bonus);
+
+    template <PlaySide Us>
+    void scoreMoves(SearchFrame &frame);
+
+    PackedMove pickMove(SearchFrame &frame);
+
+    template <PlaySide Us>
+    PackedMove nextMove(SearchFrame &frame, int ply);
+
+    bool checkTime();
+
+    void printThinking(int depth, int score);
+
+    int captureGain(PackedMove move);
+
+    template <PlaySide Us>
+    bool zugzwangRisk();
+
+    template <PlaySide Us>
+    bool remoteDrop(PackedMove move);
+
+    template <PlaySide Us>
+    int quiescence(int alpha, int beta, int ply, bool checkingDrops);
+
+    template <PlaySide Us>
+    int negamax(int alpha, int beta, int depth, int ply);
+
+ public:
+    SearchContext(TranspositionTable *transpositionTable, std::atomic<bool> *stopSignal, int id,
+                  const std::vector<SearchContext*> *threads);
+
+    /**
+     * Search the best move of the side to move in rootPosition, within the limits of timeManager.
+     * @param rootPosition position to search, left untouched
+     * @param timeManager time and depth limits, its clock is started by the search
+     * @return the best move found, NO_MOVE if there are no legal moves
+     */
+    PackedMove search(const Position &rootPosition, TimeManager &timeManager);
+
+    /**
+     * Get the nodes visited by the current or last search; safe to call from other threads.
+     */
+    uint64_t getNodes();
+
+    /**
+     * Get the nodes visited by all the search threads in their current or last search, for the
+     * reports; safe to call from other threads.
+     */
+    uint64_t getTotalNodes();
+
+    /**
+     * Get the progress of the current search, from another thread.
+     * @param depth depth of the current iteration
+     * @param movesLeft root moves the current iteration has yet to search
+     * @param movesTotal number of root moves
+     */
+    void getProgress(int &depth, int &movesLeft, int &movesTotal);
+
+    /**
+     * Print xboard thinking output (depth, score, time, nodes, principal variation) after every iteration.
+     */
+    void setPost(bool post);
+
+    /**
+     * Get the expected reply to the best move of the last search, for pondering.
+     */
+    PackedMove getPonderMove();
+};
+#endif
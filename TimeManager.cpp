@@ -0,0 +1,122 @@
+#include "TimeManager.h"
+
+#include <bits/stdc++.h>
+
+/**
+ * Start without a time control: every move gets DEFAULT_MOVE_TIME.
+*/
+TimeManager::TimeManager() {
+    movesPerSession = 0;
+    increment = 0;
+    fixedTime = 0;
+    depthLimit = 0;
+
+    engineTime = -1;
+    opponentTime = -1;
+
+    movesPlayed = 0;
+
+    softLimit = hardLimit = DEFAULT_MOVE_TIME;
+    unlimited = false;
+}
+
+void TimeManager::setLevel(int mps, int64_t base, int64_t inc) {
+    movesPerSession = mps;
+    increment = inc;
+    fixedTime = 0;
+
+    engineTime = opponentTime = base;
+    movesPlayed = 0;
+}
+
+void TimeManager::setFixedTime(int64_t time) {
+    fixedTime = time;
+}
+
+void TimeManager::setDepthLimit(int depth) {
+    depthLimit = depth;
+}
+
+void TimeManager::setEngineTime(int64_t centiseconds) {
+    engineTime = centiseconds * 10;
+}
+
+void TimeManager::setOpponentTime(int64_t centiseconds) {
+    opponentTime = centiseconds * 10;
+}
+
+int TimeManager::getDepthLimit() {
+    return depthLimit;
+}
+
+void TimeManager::startSearch() {
+    start = std::chrono::steady_clock::now();
+    computeLimits();
+}
+
+void TimeManager::startUnlimited() {
+    start = std::chrono::steady_clock::now();
+    softLimit = hardLimit = INT64_MAX;
+    unlimited = true;
+}
+
+/**
+ * The limits are measured from the start of pondering, so the search may stop right away
+ * if it has already been running for longer than the move deserves.
+*/
+void TimeManager::ponderHit() {
+    computeLimits();
+    unlimited = false;
+}
+
+/**
+ * Split the remaining time evenly between the moves left until the next time control,
+ * plus most of the increment. The hard limit lets an unstable search run up to 3 times longer,
+ * but never uses more than a third of the clock.
+*/
+void TimeManager::computeLimits() {
+    if (fixedTime > 0) {
+        softLimit = hardLimit = std::max<int64_t>(fixedTime - MOVE_OVERHEAD, MIN_MOVE_TIME);
+    } else if (engineTime >= 0) {
+        int movesToGo = movesPerSession > 0 ? movesPerSession - movesPlayed % movesPerSession : DEFAULT_MOVES_TO_GO;
+        int64_t available = std::max<int64_t>(engineTime - MOVE_OVERHEAD, MIN_MOVE_TIME);
+
+        /* being behind on the clock, spend a bit less to catch up */
+        if (opponentTime > engineTime)
+            available -= std::min(available / 4, (opponentTime - engineTime) / 2);
+
+        int64_t soft = available / movesToGo + increment * 3 / 4;
+        int64_t hard = std::min(soft * 3, available / 3);
+
+        hardLimit = std::max<int64_t>(hard, MIN_MOVE_TIME);
+        softLimit = std::max<int64_t>(std::min(soft, hard), MIN_MOVE_TIME);
+    } else {
+        softLimit = hardLimit = DEFAULT_MOVE_TIME;
+    }
+
+    movesPlayed++;
+}
+
+int64_t TimeManager::elapsed() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * The next iteration takes several times longer than the ones before: stop early if the best move
+ * has not changed for a few iterations, spend more time while it keeps changing.
+*/
+bool TimeManager::softLimitReached(int stability) {
+    static const int percentage[] = {150, 100, 75, 50};
+
+    if (unlimited)
+        return false;
+
+    if (fixedTime > 0)
+        return elapsed() >= softLimit;
+
+    return elapsed() * 100 >= softLimit * percentage[std::min(stability, 3)];
+}
+
+bool TimeManager::hardLimitReached() {
+    return elapsed() >= hardLimit;
+}
@@ -0,0 +1,97 @@
+#ifndef TIME_MANAGER_H
+#define TIME_MANAGER_H
+#include <bits/stdc++.h>
+
+#define MOVE_OVERHEAD 50       /* ms kept in reserve for the communication with xboard */
+#define MIN_MOVE_TIME 10       /* ms, lower bound of the time given to a move */
+#define DEFAULT_MOVES_TO_GO 30 /* moves left assumed when the time control has no moves per session */
+#define DEFAULT_MOVE_TIME 1000 /* ms per move when xboard sent no time control */
+
+/*
+  Per-move time allocation, from the time control set by xboard (level, st, sd)
+  and the clocks sent before each move (time, otim). A move has a soft limit,
+  after which no new iteration is started, and a hard limit, at which the search
+  is interrupted. Pondering, analysis and bench searches run without limits, pondering until the
+  opponent plays the expected move.
+ */
+class TimeManager {
+ private:
+    int movesPerSession;  /* level MPS, 0 if the whole game is played in the base time */
+    int64_t increment;    /* level INC, ms */
+    int64_t fixedTime;    /* st, ms per move, 0 if not set */
+    int depthLimit;       /* sd, 0 if not set */
+
+    int64_t engineTime;    /* engine's remaining time, ms, -1 if not known */
+    int64_t opponentTime;  /* opponent's remaining time, ms, -1 if not known */
+
+    int movesPlayed;  /* engine moves since the time control was set */
+
+    std::chrono::steady_clock::time_point start;
+    std::atomic<int64_t> softLimit, hardLimit;  /* changed by a ponder hit while the search runs */
+    std::atomic<bool> unlimited;  /* no time limits, the search stops at the depth limit or when told to */
+
+    void computeLimits();
+
+ public:
+    TimeManager();
+
+    /**
+     * Set a conventional or incremental time control (xboard "level MPS BASE INC").
+     * @param mps moves per session, 0 for the whole game
+     * @param base base time, ms
+     * @param inc increment per move, ms
+     */
+    void setLevel(int mps, int64_t base, int64_t inc);
+
+    /**
+     * Set a fixed time per move (xboard "st"), ms.
+     */
+    void setFixedTime(int64_t time);
+
+    /**
+     * Limit the search depth (xboard "sd").
+     */
+    void setDepthLimit(int depth);
+
+    /**
+     * Set the engine's remaining time (xboard "time"), centiseconds.
+     */
+    void setEngineTime(int64_t centiseconds);
+
+    /**
+     * Set the opponent's remaining time (xboard "otim"), centiseconds.
+     */
+    void setOpponentTime(int64_t centiseconds);
+
+    int getDepthLimit();
+
+    /**
+     * Start the clock of a new move and compute its soft and hard limits.
+     */
+    void startSearch();
+
+    /**
+     * Start the clock of a search without time limits: pondering (until ponderHit), analysis or bench.
+     */
+    void startUnlimited();
+
+    /**
+     * The opponent played the expected move: compute the limits of the move, counting
+     * the time already spent pondering.
+     */
+    void ponderHit();
+
+    /**
+     * Get the time elapsed since startSearch, ms.
+     */
+    int64_t elapsed();
+
+    /**
+     * Check whether a new iteration should not be started.
+     * @param stability number of consecutive iterations that returned the same best move
+     */
+    bool softLimitReached(int stability);
+
+    bool hardLimitReached();
+};
+#endif
@@ -0,0 +1,116 @@
+#include "TranspositionTable.h"
+
+#include <bits/stdc++.h>
+
+/**
+ * Allocate the largest power of 2 number of buckets that fits in the given size.
+ * @param megabytes size of the table
+*/
+TranspositionTable::TranspositionTable(size_t megabytes) {
+    uint64_t count = 1;
+    while (count * 2 * sizeof(TTBucket) <= megabytes * 1024 * 1024)
+        count *= 2;
+
+    buckets = new TTBucket[count];
+    mask = count - 1;
+
+    clear();
+}
+
+TranspositionTable::~TranspositionTable() {
+    delete[] buckets;
+}
+
+void TranspositionTable::clear() {
+    for (uint64_t i = 0; i <= mask; i++) {
+        for (int j = 0; j < BUCKET_ENTRIES; j++) {
+            buckets[i].slots[j].check.store(0, std::memory_order_relaxed);
+            buckets[i].slots[j].data.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    generation = 0;
+}
+
+void TranspositionTable::newSearch() {
+    generation++;
+}
+
+uint64_t TranspositionTable::pack(const TTEntry &entry) {
+    return (uint64_t)entry.move.data | (uint64_t)(uint16_t)entry.score << 16 | (uint64_t)(uint8_t)entry.depth << 32 |
+           (uint64_t)entry.bound << 40 | (uint64_t)entry.generation << 48;
+}
+
+TTEntry TranspositionTable::unpack(uint64_t data) {
+    TTEntry entry;
+    entry.move = PackedMove(data & 0xFFFF);
+    entry.score = (int16_t)(data >> 16);
+    entry.depth = (int8_t)(data >> 32);
+    entry.bound = (data >> 40) & 0xFF;
+    entry.generation = (data >> 48) & 0xFF;
+    return entry;
+}
+
+bool TranspositionTable::probe(uint64_t key, TTEntry &entry) {
+    TTBucket &bucket = bucketOf(key);
+
+    for (int i = 0; i < BUCKET_ENTRIES; i++) {
+        uint64_t data = bucket.slots[i].data.load(std::memory_order_relaxed);
+        uint64_t check = bucket.slots[i].check.load(std::memory_order_relaxed);
+
+        if ((check ^ data) == key && data != 0) {
+            entry = unpack(data);
+            return entry.bound != BOUND_NONE;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Store the result of a search. The entry of the same position is overwritten, otherwise the entry
+ * of the bucket with the least depth, counting entries of older searches as shallower.
+ * @param key Zobrist key of the position
+ * @param move best move found, NO_MOVE keeps the move already stored for the position
+ * @param score score of the position
+ * @param depth depth of the search
+ * @param bound whether score is exact or a bound
+*/
+void TranspositionTable::store(uint64_t key, PackedMove move, int score, int depth, Bound bound) {
+    TTBucket &bucket = bucketOf(key);
+    TTSlot *replace = nullptr;
+    TTEntry replaceEntry;
+    int replaceValue = INT_MAX;
+    bool samePosition = false;
+
+    for (int i = 0; i < BUCKET_ENTRIES; i++) {
+        TTSlot &slot = bucket.slots[i];
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        TTEntry entry = unpack(data);
+
+        if (data == 0 || (slot.check.load(std::memory_order_relaxed) ^ data) == key) {
+            replace = &slot;
+            replaceEntry = entry;
+            samePosition = data != 0;
+            break;
+        }
+
+        int age = (uint8_t)(generation - entry.generation);
+        if (entry.depth - 8 * age < replaceValue) {
+            replace = &slot;
+            replaceEntry = entry;
+            replaceValue = entry.depth - 8 * age;
+        }
+    }
+
+    TTEntry entry;
+    entry.move = (move == NO_MOVE && samePosition) ? replaceEntry.move : move;
+    entry.score = score;
+    entry.depth = depth;
+    entry.bound = bound;
+    entry.generation = generation;
+
+    uint64_t data = pack(entry);
+    replace->check.store(key ^ data, std::memory_order_relaxed);
+    replace->data.store(data, std::memory_order_relaxed);
+}
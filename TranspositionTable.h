@@ -0,0 +1,79 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+#include <bits/stdc++.h>
+
+#include "PackedMove.h"
+
+#define TT_SIZE_MB 64     /* default size of the transposition table */
+#define BUCKET_ENTRIES 4  /* entries sharing a cache line */
+
+enum Bound {
+    BOUND_NONE = 0, BOUND_UPPER = 1, BOUND_LOWER = 2, BOUND_EXACT = 3
+};
+
+/* the data of an entry, as returned by probe */
+typedef struct {
+    PackedMove move;     /* best move found, NO_MOVE if none */
+    int16_t score;
+    int8_t depth;
+    uint8_t bound;       /* Bound */
+    uint8_t generation;  /* search that stored the entry, older entries are replaced first */
+} TTEntry;
+
+/*
+  16 bytes, 4 per 64-byte cache line. The threads read and write slots without locks: the key is
+  stored XOR-ed with the data, so a slot torn by two concurrent writes fails the key check.
+ */
+typedef struct {
+    std::atomic<uint64_t> check;  /* key ^ data */
+    std::atomic<uint64_t> data;   /* TTEntry packed in 64 bits */
+} TTSlot;
+
+typedef struct alignas(64) {
+    TTSlot slots[BUCKET_ENTRIES];
+} TTBucket;
+
+/*
+  Results of searched positions, indexed by Zobrist key. A position maps to one bucket (one cache line)
+  and can be stored in any of its entries. Shared by all the search threads.
+ */
+class TranspositionTable {
+ private:
+    TTBucket *buckets;
+    uint64_t mask;  /* number of buckets - 1, a power of 2 */
+    uint8_t generation;
+
+    TTBucket& bucketOf(uint64_t key) { return buckets[key & mask]; }
+
+    static uint64_t pack(const TTEntry &entry);
+
+    static TTEntry unpack(uint64_t data);
+
+ public:
+    TranspositionTable(size_t megabytes = TT_SIZE_MB);
+
+    ~TranspositionTable();
+
+    void clear();
+
+    /**
+     * Start a new search: entries of previous searches become replaceable.
+     */
+    void newSearch();
+
+    /**
+     * Fetch the bucket of key into the cache, ahead of probe or store.
+     */
+    void prefetch(uint64_t key) { __builtin_prefetch(&bucketOf(key)); }
+
+    /**
+     * Look up a position.
+     * @param key Zobrist key of the position
+     * @param entry filled with the stored data, if found
+     * @return true if the position was found
+     */
+    bool probe(uint64_t key, TTEntry &entry);
+
+    void store(uint64_t key, PackedMove move, int score, int depth, Bound bound);
+};
+#endif
@@ -0,0 +1,45 @@
+#include "Zobrist.h"
+
+#include <bits/stdc++.h>
+
+uint64_t pieceKeys[13][SQUARES];
+uint64_t promotedKeys[SQUARES];
+uint64_t pocketKeys[2][5][MAX_POCKET + 1];
+uint64_t castleKeys[2][2];
+uint64_t enPassantKeys[8];
+uint64_t sideKey;
+
+/**
+ * splitmix64 pseudo-random number generator, with a fixed seed so that the keys are the same on every run.
+*/
+static uint64_t randomKey() {
+    static uint64_t state = 0x9E3779B97F4A7C15ULL;
+
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void initZobrist() {
+    for (int value = 0; value < 13; value++)
+        for (int sq = 0; sq < SQUARES; sq++)
+            pieceKeys[value][sq] = value ? randomKey() : 0;
+
+    for (int sq = 0; sq < SQUARES; sq++)
+        promotedKeys[sq] = randomKey();
+
+    for (int side = 0; side < 2; side++)
+        for (int piece = 0; piece < 5; piece++)
+            for (int count = 0; count <= MAX_POCKET; count++)
+                pocketKeys[side][piece][count] = count ? randomKey() : 0;
+
+    for (int side = 0; side < 2; side++)
+        for (int type = 0; type < 2; type++)
+            castleKeys[side][type] = randomKey();
+
+    for (int file = 0; file < 8; file++)
+        enPassantKeys[file] = randomKey();
+
+    sideKey = randomKey();
+}
@@ -0,0 +1,26 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+#include <bits/stdc++.h>
+
+#include "Bitboard.h"
+
+/* upper bound on the number of pieces of one type in a pocket: all 16 pawns, or 2 + 8 promoted pieces */
+#define MAX_POCKET 16
+
+/*
+  Random keys XOR-ed together into the hash of a position: one per piece on a square, per number of
+  pieces of a type in a pocket, per castling right, per en passant file and for the side to move.
+ */
+extern uint64_t pieceKeys[13][SQUARES];                  /* pieceKeys[BoardPiece][sq], pieceKeys[EMPTY] unused */
+extern uint64_t promotedKeys[SQUARES];                   /* promoted pawn on sq */
+extern uint64_t pocketKeys[2][5][MAX_POCKET + 1];        /* pocketKeys[playSide][piece][count], 0 for an empty pocket */
+extern uint64_t castleKeys[2][2];                        /* castleKeys[playSide][type] */
+extern uint64_t enPassantKeys[8];                        /* en passant square on file + 1 */
+extern uint64_t sideKey;                                 /* WHITE to move */
+
+/**
+ * Fill the key tables. Must be called once, before any Position is created.
+*/
+void initZobrist();
+
+#endif
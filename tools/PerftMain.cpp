@@ -0,0 +1,62 @@
+#include <bits/stdc++.h>
+
+#include "../Bitboard.h"
+#include "../Evaluation.h"
+#include "../Move.h"
+#include "../Perft.h"
+#include "../Position.h"
+#include "../Zobrist.h"
+
+/*
+  Standalone perft: ./perft [-divide] [-threads N] [-hash MB] [-fen FEN] depth [moves...]
+  Counts the leaf nodes at depth from the start position (or the crazyhouse FEN, given as a single
+  argument), after playing the given moves (in coordinate notation, e.g. e2e4 P@e5).
+ */
+int main(int argc, char **argv) {
+    initBitboards();
+    initZobrist();
+    initEvaluation();
+
+    bool divide = false;
+    int threads = 1, depth = 0;
+    size_t hashMegabytes = PERFT_HASH_MB;
+    Position position;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (arg == "-divide") {
+            divide = true;
+        } else if (arg == "-threads" && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (arg == "-hash" && i + 1 < argc) {
+            hashMegabytes = atoi(argv[++i]);
+        } else if (arg == "-fen" && i + 1 < argc) {
+            if (!position.setFEN(argv[++i])) {
+                std::cerr << "invalid FEN: " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (depth == 0) {
+            depth = atoi(arg.c_str());
+        } else {
+            Move *move;
+            if (arg[1] == '@')
+                move = Move::dropIn(arg.substr(2, 2), Piece(std::string("PRBNQ").find(arg[0])));
+            else if (arg.length() == 5)
+                move = Move::promote(arg.substr(0, 2), arg.substr(2, 2), Piece(std::string("prbnq").find(arg[4])));
+            else
+                move = Move::moveTo(arg.substr(0, 2), arg.substr(2, 2));
+
+            position.doMove(position.parseMove(move));
+            delete move;
+        }
+    }
+
+    if (depth < 1) {
+        std::cerr << "usage: " << argv[0] << " [-divide] [-threads N] [-hash MB] [-fen FEN] depth [moves...]\n";
+        return 1;
+    }
+
+    Perft(threads, hashMegabytes).run(position, depth, divide, std::cout);
+    return 0;
+}